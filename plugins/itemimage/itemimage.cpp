@@ -9,12 +9,18 @@
 #include "gui/pixelratio.h"
 
 #include <QBuffer>
+#include <QCache>
+#include <QCryptographicHash>
 #include <QHBoxLayout>
+#include <QImageReader>
 #include <QModelIndex>
 #include <QMovie>
+#include <QMutex>
 #include <QPainter>
 #include <QPixmap>
+#include <QRunnable>
 #include <QSettings>
+#include <QThreadPool>
 #include <QtPlugin>
 #include <QVariant>
 
@@ -78,18 +84,102 @@ bool getAnimatedImageData(const QVariantMap &dataMap, QByteArray *data, QByteArr
     return false;
 }
 
-bool getPixmapFromData(const QVariantMap &dataMap, QPixmap *pix)
+QPixmap scaledPixmap(QPixmap pix, int w, int h)
 {
-    QString mime;
-    QByteArray data;
-    if ( !getImageData(dataMap, &data, &mime) && !getSvgData(dataMap, &data, &mime) )
-        return false;
+    if ( w > 0 && pix.width() > w && (h <= 0 || 1.0 * pix.width()/w > 1.0 * pix.height()/h) ) {
+        pix = pix.scaledToWidth(w, Qt::SmoothTransformation);
+    } else if (h > 0 && pix.height() > h) {
+        pix = pix.scaledToHeight(h, Qt::SmoothTransformation);
+    }
+    return pix;
+}
 
-    pix->loadFromData( data, mime.toLatin1() );
+/// Returns size of image scaled same way as with scaledPixmap().
+QSize scaledSize(QSize size, int w, int h)
+{
+    if ( w > 0 && size.width() > w && (h <= 0 || 1.0 * size.width()/w > 1.0 * size.height()/h) )
+        return QSize( w, qMax(1, qRound(1.0 * size.height() * w / size.width())) );
 
-    return true;
+    if (h > 0 && size.height() > h)
+        return QSize( qMax(1, qRound(1.0 * size.width() * h / size.height())), h );
+
+    return size;
 }
 
+// Thumbnails are kept only in memory so that image data from encrypted
+// tabs is never written to disk unencrypted.
+const int thumbnailCacheMaxKiB = 32 * 1024;
+
+QMutex thumbnailCacheMutex;
+
+QCache<QByteArray, QImage> &thumbnailCache()
+{
+    static QCache<QByteArray, QImage> cache(thumbnailCacheMaxKiB);
+    return cache;
+}
+
+int thumbnailCost(const QImage &image)
+{
+    return qMax(1, image.bytesPerLine() * image.height() / 1024);
+}
+
+/**
+ * Decodes image directly to the target size.
+ *
+ * If caching is enabled, downscaled images are kept in a bounded
+ * in-memory cache and reused.
+ */
+class ImageLoadTask final : public QRunnable
+{
+public:
+    ImageLoadTask(
+            const QByteArray &data, QSize size, bool useCache,
+            ItemImageLoadNotifier *notifier)
+        : m_data(data)
+        , m_size(size)
+        , m_useCache(useCache)
+        , m_notifier(notifier)
+    {
+    }
+
+    void run() override
+    {
+        QByteArray cacheKey;
+        QImage image;
+        if (m_useCache) {
+            cacheKey = QCryptographicHash::hash(m_data, QCryptographicHash::Sha1)
+                    + QByteArray::number(m_size.width())
+                    + 'x' + QByteArray::number(m_size.height());
+            QMutexLocker lock(&thumbnailCacheMutex);
+            if ( const QImage *cached = thumbnailCache().object(cacheKey) )
+                image = *cached;
+        }
+
+        if ( image.isNull() ) {
+            QBuffer buffer(&m_data);
+            buffer.open(QIODevice::ReadOnly);
+            QImageReader reader(&buffer);
+            if ( reader.size() != m_size )
+                reader.setScaledSize(m_size);
+            image = reader.read();
+
+            if ( !image.isNull() && !cacheKey.isEmpty() ) {
+                QMutexLocker lock(&thumbnailCacheMutex);
+                thumbnailCache().insert( cacheKey, new QImage(image), thumbnailCost(image) );
+            }
+        }
+
+        emit m_notifier->loaded(image);
+        m_notifier->deleteLater();
+    }
+
+private:
+    QByteArray m_data;
+    QSize m_size;
+    bool m_useCache;
+    ItemImageLoadNotifier *m_notifier;
+};
+
 } // namespace
 
 ItemImage::ItemImage(
@@ -138,6 +228,17 @@ void ItemImage::setCurrent(bool current)
     }
 }
 
+void ItemImage::setImage(const QImage &image)
+{
+    if ( image.isNull() )
+        return;
+
+    m_pixmap = QPixmap::fromImage(image);
+    m_pixmap.setDevicePixelRatio( pixelRatio(this) );
+    if ( !movie() )
+        setPixmap(m_pixmap);
+}
+
 void ItemImage::showEvent(QShowEvent *event)
 {
     startAnimation();
@@ -187,27 +288,46 @@ ItemWidget *ItemImageLoader::create(const QVariantMap &data, QWidget *parent, bo
     if ( data.value(mimeHidden).toBool() )
         return nullptr;
 
-    // TODO: Just check if image provided and load it in different thread.
-    QPixmap pix;
-    if ( !getPixmapFromData(data, &pix) )
+    QString mime;
+    QByteArray imageData;
+    if ( !getImageData(data, &imageData, &mime) && !getSvgData(data, &imageData, &mime) )
         return nullptr;
 
-    pix.setDevicePixelRatio( pixelRatio(parent) );
+    QByteArray animationData;
+    QByteArray animationFormat;
+    getAnimatedImageData(data, &animationData, &animationFormat);
 
-    // scale pixmap
     const int w = preview ? 0 : m_maxImageWidth;
     const int h = preview ? 0 : m_maxImageHeight;
-    if ( w > 0 && pix.width() > w && (h <= 0 || 1.0 * pix.width()/w > 1.0 * pix.height()/h) ) {
-        pix = pix.scaledToWidth(w, Qt::SmoothTransformation);
-    } else if (h > 0 && pix.height() > h) {
-        pix = pix.scaledToHeight(h, Qt::SmoothTransformation);
+
+    // Read only image size from header and decode the image later in a worker thread.
+    QBuffer buffer(&imageData);
+    buffer.open(QIODevice::ReadOnly);
+    const QSize imageSize = QImageReader(&buffer).size();
+    buffer.close();
+
+    if ( !imageSize.isValid() ) {
+        QPixmap pix;
+        pix.loadFromData( imageData, mime.toLatin1() );
+        pix.setDevicePixelRatio( pixelRatio(parent) );
+        return new ItemImage(scaledPixmap(pix, w, h), animationData, animationFormat, parent);
     }
 
-    QByteArray animationData;
-    QByteArray animationFormat;
-    getAnimatedImageData(data, &animationData, &animationFormat);
+    const QSize size = scaledSize(imageSize, w, h);
+    QPixmap placeholder(size);
+    placeholder.fill(Qt::transparent);
+    placeholder.setDevicePixelRatio( pixelRatio(parent) );
+    auto item = new ItemImage(placeholder, animationData, animationFormat, parent);
+
+    // Cache only downscaled images (thumbnails).
+    const bool useCache = size != imageSize;
+
+    auto notifier = new ItemImageLoadNotifier();
+    connect( notifier, &ItemImageLoadNotifier::loaded,
+             item, &ItemImage::setImage, Qt::QueuedConnection );
+    QThreadPool::globalInstance()->start( new ImageLoadTask(imageData, size, useCache, notifier) );
 
-    return new ItemImage(pix, animationData, animationFormat, parent);
+    return item;
 }
 
 QStringList ItemImageLoader::formatsToSave() const
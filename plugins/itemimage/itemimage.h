@@ -6,6 +6,7 @@
 #include "gui/icons.h"
 #include "item/itemwidget.h"
 
+#include <QImage>
 #include <QLabel>
 #include <QPixmap>
 
@@ -17,6 +18,15 @@ namespace Ui {
 class ItemImageSettings;
 }
 
+/// Notifies about image decoded in a worker thread.
+class ItemImageLoadNotifier final : public QObject
+{
+    Q_OBJECT
+
+signals:
+    void loaded(const QImage &image);
+};
+
 class ItemImage final : public QLabel, public ItemWidget
 {
     Q_OBJECT
@@ -31,6 +41,9 @@ public:
 
     void setCurrent(bool current) override;
 
+    /// Replaces placeholder with the loaded image.
+    void setImage(const QImage &image);
+
 protected:
     void showEvent(QShowEvent *event) override;
     void hideEvent(QHideEvent *event) override;
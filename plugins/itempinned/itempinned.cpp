@@ -163,6 +163,10 @@ ItemPinnedSaver::ItemPinnedSaver(QAbstractItemModel *model, const ItemSaverPtr &
              this, &ItemPinnedSaver::onRowsMoved );
     connect( model, &QAbstractItemModel::dataChanged,
              this, &ItemPinnedSaver::onDataChanged );
+    connect( model, &QAbstractItemModel::layoutAboutToBeChanged,
+             this, &ItemPinnedSaver::onLayoutAboutToBeChanged );
+    connect( model, &QAbstractItemModel::layoutChanged,
+             this, &ItemPinnedSaver::onLayoutChanged );
 
     updateLastPinned( 0, m_model->rowCount() );
 }
@@ -283,6 +287,70 @@ void ItemPinnedSaver::onDataChanged(const QModelIndex &topLeft, const QModelInde
     updateLastPinned( topLeft.row(), bottomRight.row() );
 }
 
+void ItemPinnedSaver::onLayoutAboutToBeChanged()
+{
+    m_pinnedBeforeLayoutChange.clear();
+    m_pinnedRowsBeforeLayoutChange.clear();
+
+    if (!m_model)
+        return;
+
+    for (int row = 0; row <= m_lastPinned; ++row) {
+        const auto index = m_model->index(row, 0);
+        if ( isPinned(index) ) {
+            m_pinnedBeforeLayoutChange.append(index);
+            m_pinnedRowsBeforeLayoutChange.append(row);
+        }
+    }
+}
+
+void ItemPinnedSaver::onLayoutChanged()
+{
+    if (!m_model)
+        return;
+
+    const auto pinned = m_pinnedBeforeLayoutChange;
+    const auto pinnedRows = m_pinnedRowsBeforeLayoutChange;
+    m_pinnedBeforeLayoutChange.clear();
+    m_pinnedRowsBeforeLayoutChange.clear();
+
+    bool moved = false;
+    for (int i = 0; !moved && i < pinned.size(); ++i)
+        moved = pinned[i].isValid() && pinned[i].row() != pinnedRows[i];
+
+    if (moved) {
+        disconnect( m_model.data(), &QAbstractItemModel::rowsMoved,
+                    this, &ItemPinnedSaver::onRowsMoved );
+
+        // Move pinned items to top keeping their order and then down to
+        // their original rows, so other items keep their new order.
+        int top = 0;
+        QVector<int> targetRows;
+        for (int i = 0; i < pinned.size(); ++i) {
+            if ( !pinned[i].isValid() )
+                continue;
+            const int row = pinned[i].row();
+            if (row != top)
+                moveRow(row, top);
+            targetRows.append(pinnedRows[i]);
+            ++top;
+        }
+
+        const int rowCount = m_model->rowCount();
+        for (int i = targetRows.size() - 1; i >= 0; --i) {
+            const int targetRow = std::min(targetRows[i], rowCount - 1);
+            if (targetRow > i)
+                moveRow(i, targetRow + 1);
+        }
+
+        connect( m_model.data(), &QAbstractItemModel::rowsMoved,
+                 this, &ItemPinnedSaver::onRowsMoved );
+    }
+
+    m_lastPinned = -1;
+    updateLastPinned( 0, m_model->rowCount() - 1 );
+}
+
 void ItemPinnedSaver::moveRow(int from, int to)
 {
     m_model->moveRow(QModelIndex(), from, QModelIndex(), to);
@@ -7,6 +7,8 @@
 #include "item/itemwidgetwrapper.h"
 #include "item/itemsaverwrapper.h"
 
+#include <QPersistentModelIndex>
+#include <QVector>
 #include <QWidget>
 
 class ItemPinned final : public QWidget, public ItemWidgetWrapper
@@ -57,6 +59,8 @@ private:
     void onRowsRemoved(const QModelIndex &parent, int start, int end);
     void onRowsMoved(const QModelIndex &, int start, int end, const QModelIndex &, int destinationRow);
     void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void onLayoutAboutToBeChanged();
+    void onLayoutChanged();
 
     void moveRow(int from, int to);
     void updateLastPinned(int from, int to);
@@ -65,6 +69,10 @@ private:
 
     // Last pinned row in list (improves performance of updates).
     int m_lastPinned = -1;
+
+    // Pinned items and their rows before layout change (e.g. sorting).
+    QVector<QPersistentModelIndex> m_pinnedBeforeLayoutChange;
+    QVector<int> m_pinnedRowsBeforeLayoutChange;
 };
 
 class ItemPinnedLoader final : public QObject, public ItemLoaderInterface
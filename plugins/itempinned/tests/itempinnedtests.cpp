@@ -133,6 +133,20 @@ void ItemPinnedTests::pinToRow()
     RUN(read << "0" << "1" << "2", "a b d");
 }
 
+void ItemPinnedTests::sortKeepsPinnedRows()
+{
+    const auto read = Args() << "separator" << " " << "read";
+
+    RUN("add" << "a" << "d" << "b" << "e" << "c", "");
+    RUN(read << "0" << "1" << "2" << "3" << "4", "c e b d a");
+    RUN("-e" << "plugins.itempinned.pin(1, 3)", "");
+
+    RUN("-e" << "ItemSelection().selectAll().sortBy(mimeText)", "");
+    RUN(read << "0" << "1" << "2" << "3" << "4", "a e b d c");
+    RUN("-e" << "plugins.itempinned.isPinned(1)", "true\n");
+    RUN("-e" << "plugins.itempinned.isPinned(3)", "true\n");
+}
+
 void ItemPinnedTests::fullTab()
 {
     RUN("config" << "maxitems" << "3", "3\n");
@@ -29,6 +29,8 @@ private slots:
 
     void pinToRow();
 
+    void sortKeepsPinnedRows();
+
     void fullTab();
 
 private:
@@ -16,7 +16,9 @@
 #include <QRegularExpression>
 #include <QUrl>
 
+#include <algorithm>
 #include <array>
+#include <functional>
 #include <vector>
 
 const QLatin1String mimeExtensionMap(COPYQ_MIME_PREFIX_ITEMSYNC "mime-to-extension-map");
@@ -444,6 +446,10 @@ FileWatcher::FileWatcher(
              this, &FileWatcher::onRowsRemoved );
     connect( model, &QAbstractItemModel::rowsMoved,
              this, &FileWatcher::onRowsMoved );
+    connect( m_model, &QAbstractItemModel::layoutAboutToBeChanged,
+             this, &FileWatcher::onLayoutAboutToBeChanged );
+    connect( m_model, &QAbstractItemModel::layoutChanged,
+             this, &FileWatcher::onLayoutChanged );
     connect( m_model, &QAbstractItemModel::dataChanged,
              this, &FileWatcher::onDataChanged );
 
@@ -715,6 +721,28 @@ void FileWatcher::onRowsMoved(const QModelIndex &, int start, int end, const QMo
     }
 }
 
+void FileWatcher::onLayoutAboutToBeChanged()
+{
+    m_indexesBeforeLayoutChange = indexList(0, m_model->rowCount() - 1);
+}
+
+void FileWatcher::onLayoutChanged()
+{
+    QList<int> movedRows;
+    for (int row = 0; row < m_indexesBeforeLayoutChange.size(); ++row) {
+        const auto &index = m_indexesBeforeLayoutChange[row];
+        if ( index.isValid() && index.row() != row )
+            movedRows.append( index.row() );
+    }
+    m_indexesBeforeLayoutChange.clear();
+
+    // Handle each moved item as if it was moved just above its new neighbor,
+    // starting from bottom so the neighbor is already at its final place.
+    std::sort( movedRows.begin(), movedRows.end(), std::greater<int>() );
+    for (const int row : movedRows)
+        onRowsMoved(QModelIndex(), row + 1, row + 1, QModelIndex(), row);
+}
+
 QString FileWatcher::oldBaseName(const QModelIndex &index) const
 {
     return index.data(contentType::data).toMap().value(mimeOldBaseName).toString();
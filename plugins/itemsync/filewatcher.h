@@ -90,6 +90,10 @@ private:
 
     void onRowsMoved(const QModelIndex &, int start, int end, const QModelIndex &, int destinationRow);
 
+    void onLayoutAboutToBeChanged();
+
+    void onLayoutChanged();
+
     QString oldBaseName(const QModelIndex &index) const;
 
     void createItems(const QVector<QVariantMap> &dataMaps, int targetRow);
@@ -119,6 +123,7 @@ private:
     qint64 m_lastUpdateTimeMs = 0;
 
     QList<QPersistentModelIndex> m_batchIndexData;
+    QList<QPersistentModelIndex> m_indexesBeforeLayoutChange;
     BaseNameExtensionsList m_fileList;
     int m_lastBatchIndex = -1;
 };
@@ -17,6 +17,7 @@
 #   include "tests/itemtagstests.h"
 #endif
 
+#include <QAbstractItemModel>
 #include <QBoxLayout>
 #include <QColorDialog>
 #include <QLabel>
@@ -258,41 +259,34 @@ void addTagButtons(QBoxLayout *layout, const ItemTags::Tags &tags)
     }
 }
 
-ItemTags::Tag findMatchingTag(const QString &tagText, const ItemTags::Tags &tags)
+ItemTagMatchers compileTagMatchers(const ItemTags::Tags &tags)
 {
+    ItemTagMatchers matchers;
+    matchers.reserve( tags.size() );
     for (const auto &tag : tags) {
-        if ( tag.match.isEmpty() ) {
-            if (tag.name == tagText)
-                return tag;
-        } else {
-            const auto re = anchoredRegExp(tag.match);
-            if (tagText.contains(re))
-                return tag;
+        ItemTagMatcher matcher;
+        matcher.tag = tag;
+        if ( !tag.match.isEmpty() ) {
+            matcher.re = QRegularExpression(tag.match);
+            matcher.anchoredRe = anchoredRegExp(tag.match);
         }
+        matchers.append(matcher);
     }
-
-    return ItemTags::Tag();
+    return matchers;
 }
 
-bool isLocked(const QModelIndex &index, const ItemTags::Tags &tags)
+const ItemTagMatcher *findMatchingTag(const QString &tagText, const ItemTagMatchers &matchers)
 {
-    const auto dataMap = index.data(contentType::data).toMap();
-    const auto itemTags = ::tags(dataMap);
-    return std::any_of(
-        std::begin(itemTags), std::end(itemTags),
-        [&tags](const QString &itemTag){
-            const auto tag = findMatchingTag(itemTag, tags);
-            return tag.lock;
-        });
-}
+    for (const auto &matcher : matchers) {
+        if ( matcher.tag.match.isEmpty() ) {
+            if (matcher.tag.name == tagText)
+                return &matcher;
+        } else if ( tagText.contains(matcher.anchoredRe) ) {
+            return &matcher;
+        }
+    }
 
-bool containsLockedItems(const QModelIndexList &indexList, const ItemTags::Tags &tags)
-{
-    return std::any_of(
-        std::begin(indexList), std::end(indexList),
-        [&tags](const QModelIndex &index){
-            return isLocked(index, tags);
-        });
+    return nullptr;
 }
 
 class TagTableWidgetItem final : public QTableWidgetItem
@@ -590,15 +584,71 @@ bool ItemTagsScriptable::removeTag(const QString &tagName, QStringList *tags)
     return true;
 }
 
-ItemTagsSaver::ItemTagsSaver(const ItemTags::Tags &tags, const ItemSaverPtr &saver)
+ItemTagsIndex::ItemTagsIndex(QAbstractItemModel *model, const ItemTagMatchers &matchers)
+    : QObject(model)
+    , m_model(model)
+    , m_matchers(matchers)
+{
+    connect( model, &QAbstractItemModel::rowsAboutToBeRemoved,
+             this, &ItemTagsIndex::onRowsAboutToBeRemoved );
+    connect( model, &QAbstractItemModel::modelReset,
+             this, [this]() { m_entries.clear(); } );
+}
+
+const QString &ItemTagsIndex::tagsText(const QModelIndex &index)
+{
+    return entry(index).text;
+}
+
+bool ItemTagsIndex::hasTag(const QModelIndex &index, const QString &tagName)
+{
+    return entry(index).tags.contains(tagName);
+}
+
+bool ItemTagsIndex::isLocked(const QModelIndex &index)
+{
+    return entry(index).locked;
+}
+
+const ItemTagsIndex::Entry &ItemTagsIndex::entry(const QModelIndex &index)
+{
+    const uint hash = index.data(contentType::hash).toUInt();
+    const auto it = m_entries.constFind(hash);
+    if ( it != m_entries.constEnd() )
+        return it.value();
+
+    // Drop entries for items changed since they were cached.
+    if ( m_entries.size() > 2 * m_model->rowCount() + 100 )
+        m_entries.clear();
+
+    Entry newEntry;
+    newEntry.text = getTextData( index.data(contentType::data).toMap().value(mimeTags).toByteArray() );
+    for (const auto &tagText : newEntry.text.split(',', SKIP_EMPTY_PARTS)) {
+        const QString tagName = tagText.trimmed();
+        newEntry.tags.append(tagName);
+        const auto matcher = findMatchingTag(tagName, m_matchers);
+        if (matcher && matcher->tag.lock)
+            newEntry.locked = true;
+    }
+
+    return m_entries.insert(hash, newEntry).value();
+}
+
+void ItemTagsIndex::onRowsAboutToBeRemoved(const QModelIndex &, int first, int last)
+{
+    for (int row = first; row <= last; ++row)
+        m_entries.remove( m_model->index(row, 0).data(contentType::hash).toUInt() );
+}
+
+ItemTagsSaver::ItemTagsSaver(ItemTagsIndex *tagsIndex, const ItemSaverPtr &saver)
     : ItemSaverWrapper(saver)
-    , m_tags(tags)
+    , m_tagsIndex(tagsIndex)
 {
 }
 
 bool ItemTagsSaver::canRemoveItems(const QList<QModelIndex> &indexList, QString *error)
 {
-    if ( !containsLockedItems(indexList, m_tags) )
+    if ( !containsLockedItems(indexList) )
         return ItemSaverWrapper::canRemoveItems(indexList, error);
 
     if (error) {
@@ -615,15 +665,29 @@ bool ItemTagsSaver::canRemoveItems(const QList<QModelIndex> &indexList, QString
 
 bool ItemTagsSaver::canDropItem(const QModelIndex &index)
 {
-    return !isLocked(index, m_tags) && ItemSaverWrapper::canDropItem(index);
+    return !isLocked(index) && ItemSaverWrapper::canDropItem(index);
 }
 
 bool ItemTagsSaver::canMoveItems(const QList<QModelIndex> &indexList)
 {
-    return !containsLockedItems(indexList, m_tags)
+    return !containsLockedItems(indexList)
             && ItemSaverWrapper::canMoveItems(indexList);
 }
 
+bool ItemTagsSaver::isLocked(const QModelIndex &index) const
+{
+    return m_tagsIndex && m_tagsIndex->isLocked(index);
+}
+
+bool ItemTagsSaver::containsLockedItems(const QList<QModelIndex> &indexList) const
+{
+    return std::any_of(
+        std::begin(indexList), std::end(indexList),
+        [this](const QModelIndex &index){
+            return isLocked(index);
+        });
+}
+
 ItemTagsLoader::ItemTagsLoader()
     : m_blockDataChange(false)
 {
@@ -657,6 +721,7 @@ void ItemTagsLoader::loadSettings(const QSettings &settings)
         if (isTagValid(tag))
             m_tags.append(tag);
     }
+    m_tagMatchers = compileTagMatchers(m_tags);
 }
 
 QWidget *ItemTagsLoader::createSettingsWidget(QWidget *parent)
@@ -695,20 +760,42 @@ ItemWidget *ItemTagsLoader::transform(ItemWidget *itemWidget, const QVariantMap
     return new ItemTags(itemWidget, tags);
 }
 
-ItemSaverPtr ItemTagsLoader::transformSaver(const ItemSaverPtr &saver, QAbstractItemModel *)
+ItemSaverPtr ItemTagsLoader::transformSaver(const ItemSaverPtr &saver, QAbstractItemModel *model)
 {
+    for (auto it = m_tagsIndexes.begin(); it != m_tagsIndexes.end(); ) {
+        if ( it.value().isNull() )
+            it = m_tagsIndexes.erase(it);
+        else
+            ++it;
+    }
+
+    auto &tagsIndex = m_tagsIndexes[model];
+    delete tagsIndex.data();
+    tagsIndex = new ItemTagsIndex(model, m_tagMatchers);
+
     // Avoid checking for locked items if no locked tags are specified in configuration.
     const bool hasAnyLocks = std::any_of(
         std::begin(m_tags), std::end(m_tags),
         [](const ItemTags::Tag &tag){ return tag.lock; });
-    return hasAnyLocks ? std::make_shared<ItemTagsSaver>(m_tags, saver) : saver;
+    return hasAnyLocks ? std::make_shared<ItemTagsSaver>(tagsIndex.data(), saver) : saver;
 }
 
 bool ItemTagsLoader::matches(const QModelIndex &index, const ItemFilter &filter) const
 {
-    const QByteArray tagsData =
-            index.data(contentType::data).toMap().value(mimeTags).toByteArray();
-    const auto tags = getTextData(tagsData);
+    const auto tagsIndex = m_tagsIndexes.value(index.model());
+    if (!tagsIndex) {
+        const QByteArray tagsData =
+                index.data(contentType::data).toMap().value(mimeTags).toByteArray();
+        const auto tags = getTextData(tagsData);
+        return filter.matches(tags) || filter.matches(accentsRemoved(tags));
+    }
+
+    // Search for "tag:NAME" matches only items with the exact tag.
+    const QString searchString = filter.searchString();
+    if ( searchString.startsWith(QLatin1String("tag:")) )
+        return tagsIndex->hasTag( index, searchString.mid(4).trimmed() );
+
+    const QString &tags = tagsIndex->tagsText(index);
     return filter.matches(tags) || filter.matches(accentsRemoved(tags));
 }
 
@@ -856,15 +943,14 @@ ItemTagsLoader::Tags ItemTagsLoader::toTags(const QStringList &tagList)
 
     for (const auto &tagText : tagList) {
         QString tagName = tagText.trimmed();
-        Tag tag = findMatchingTag(tagName, m_tags);
+        const auto matcher = findMatchingTag(tagName, m_tagMatchers);
+        Tag tag = matcher ? matcher->tag : Tag();
 
-        if (isTagValid(tag)) {
-            if (tag.match.isEmpty()) {
+        if (matcher && isTagValid(tag)) {
+            if (tag.match.isEmpty())
                 tag.name = tagName;
-            } else {
-                const QRegularExpression re(tag.match);
-                tag.name = QString(tagName).replace(re, tag.name);
-            }
+            else
+                tag.name = QString(tagName).replace(matcher->re, tag.name);
         } else {
             tag.name = tagName;
 
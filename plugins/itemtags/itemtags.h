@@ -7,6 +7,10 @@
 #include "item/itemwidgetwrapper.h"
 #include "item/itemsaverwrapper.h"
 
+#include <QHash>
+#include <QPointer>
+#include <QRegularExpression>
+#include <QStringList>
 #include <QVariant>
 #include <QVector>
 #include <QWidget>
@@ -45,6 +49,48 @@ private:
     QWidget *m_tagWidget;
 };
 
+/// Configured tag with precompiled regular expressions.
+struct ItemTagMatcher {
+    ItemTags::Tag tag;
+    QRegularExpression re;
+    QRegularExpression anchoredRe;
+};
+
+using ItemTagMatchers = QVector<ItemTagMatcher>;
+
+/**
+ * Parsed tags of items in a tab.
+ *
+ * Items are looked up by data hash, so cached tags stay valid when rows move
+ * and changed items are parsed again.
+ */
+class ItemTagsIndex final : public QObject
+{
+public:
+    ItemTagsIndex(QAbstractItemModel *model, const ItemTagMatchers &matchers);
+
+    const QString &tagsText(const QModelIndex &index);
+
+    bool hasTag(const QModelIndex &index, const QString &tagName);
+
+    bool isLocked(const QModelIndex &index);
+
+private:
+    struct Entry {
+        QString text;
+        QStringList tags;
+        bool locked = false;
+    };
+
+    const Entry &entry(const QModelIndex &index);
+
+    void onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+
+    QAbstractItemModel *m_model;
+    ItemTagMatchers m_matchers;
+    QHash<uint, Entry> m_entries;
+};
+
 class ItemTagsLoader;
 
 class ItemTagsScriptable final : public ItemScriptable
@@ -85,7 +131,7 @@ private:
 class ItemTagsSaver final : public ItemSaverWrapper
 {
 public:
-    ItemTagsSaver(const ItemTags::Tags &tags, const ItemSaverPtr &saver);
+    ItemTagsSaver(ItemTagsIndex *tagsIndex, const ItemSaverPtr &saver);
 
     bool canRemoveItems(const QList<QModelIndex> &indexList, QString *error) override;
 
@@ -94,7 +140,10 @@ public:
     bool canMoveItems(const QList<QModelIndex> &indexList) override;
 
 private:
-    ItemTags::Tags m_tags;
+    bool isLocked(const QModelIndex &index) const;
+    bool containsLockedItems(const QList<QModelIndex> &indexList) const;
+
+    QPointer<ItemTagsIndex> m_tagsIndex;
 };
 
 class ItemTagsLoader final : public QObject, public ItemLoaderInterface
@@ -155,6 +204,8 @@ private:
     Tag tagFromTable(int row);
 
     Tags m_tags;
+    ItemTagMatchers m_tagMatchers;
+    QHash<const QAbstractItemModel*, QPointer<ItemTagsIndex>> m_tagsIndexes;
     std::unique_ptr<Ui::ItemTagsSettings> ui;
 
     bool m_blockDataChange;
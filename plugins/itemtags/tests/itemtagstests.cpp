@@ -195,6 +195,13 @@ void ItemTagsTests::searchTags()
     RUN(args << "keys" << "t" << "a" << "g" << "3", "");
     RUN(args << "keys" << "TAB" << "CTRL+A", "");
     RUN(args << "testSelected", tab1 + " 2 2\n");
+
+    // Search for exact tag.
+    RUN(args << "-e" << "plugins.itemtags.tag('tag10', 2)", "");
+    RUN(args << "keys" << "ESCAPE", "");
+    RUN(args << "keys" << ":tag:tag1", "");
+    RUN(args << "keys" << "TAB" << "CTRL+A", "");
+    RUN(args << "testSelected", tab1 + " 0 0 1\n");
 }
 
 void ItemTagsTests::tagSelected()
@@ -7,6 +7,7 @@
 #include "common/log.h"
 #include "common/settings.h"
 #include "common/textdata.h"
+#include "common/trace.h"
 #include "platform/platformnativeinterface.h"
 #ifdef Q_OS_UNIX
 #   include "platform/unix/unixsignalhandler.h"
@@ -151,6 +152,7 @@ App::App(QCoreApplication *application,
 #endif
 
     initLogging();
+    initTracing();
 }
 
 App::~App()
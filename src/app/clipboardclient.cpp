@@ -16,11 +16,111 @@
 #include <QApplication>
 #include <QFile>
 #include <QJSEngine>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QThread>
 #include <QTimer>
 
 namespace {
 
+const QString sessionPipeArgument = QStringLiteral("--session-pipe");
+
+struct SessionPipeRequest {
+    QJsonValue id;
+    QStringList arguments;
+    QByteArray input;
+};
+
+/// Splits command to arguments separated by white space (allows quoting).
+QStringList splitSessionPipeCommand(const QString &command)
+{
+    QStringList arguments;
+    QString argument;
+    bool hasArgument = false;
+    QChar quote;
+
+    for (const auto &c : command) {
+        if ( !quote.isNull() ) {
+            if (c == quote)
+                quote = QChar();
+            else
+                argument.append(c);
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+            hasArgument = true;
+        } else if ( c.isSpace() ) {
+            if (hasArgument) {
+                arguments.append(argument);
+                argument.clear();
+                hasArgument = false;
+            }
+        } else {
+            argument.append(c);
+            hasArgument = true;
+        }
+    }
+
+    if (hasArgument)
+        arguments.append(argument);
+
+    return arguments;
+}
+
+bool toArguments(const QJsonValue &value, QStringList *arguments)
+{
+    if ( !value.isArray() )
+        return false;
+
+    for ( const auto &argument : value.toArray() ) {
+        if ( !argument.isString() )
+            return false;
+        arguments->append( argument.toString() );
+    }
+
+    return true;
+}
+
+/**
+ * Parses request from a line which is either:
+ * - command arguments separated by white space,
+ * - JSON array with arguments or
+ * - JSON object with "args" array, optional "id" and "input".
+ */
+bool parseSessionPipeRequest(
+        const QByteArray &line, int lineNumber, SessionPipeRequest *request, QByteArray *error)
+{
+    request->id = lineNumber;
+
+    const QByteArray trimmedLine = line.trimmed();
+    if ( !trimmedLine.startsWith('{') && !trimmedLine.startsWith('[') ) {
+        request->arguments = splitSessionPipeCommand( QString::fromUtf8(trimmedLine) );
+        return true;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument json = QJsonDocument::fromJson(trimmedLine, &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        *error = "Invalid request: " + parseError.errorString().toUtf8() + "\n";
+        return false;
+    }
+
+    if ( json.isArray() ) {
+        if ( toArguments(json.array(), &request->arguments) )
+            return true;
+    } else {
+        const QJsonObject object = json.object();
+        if ( object.contains(QStringLiteral("id")) )
+            request->id = object.value(QStringLiteral("id"));
+        request->input = object.value(QStringLiteral("input")).toString().toUtf8();
+        if ( toArguments(object.value(QStringLiteral("args")), &request->arguments) )
+            return true;
+    }
+
+    *error = "Invalid request: expected array of string arguments\n";
+    return false;
+}
+
 QString messageCodeToString(int code)
 {
     switch (code) {
@@ -56,8 +156,11 @@ QCoreApplication *createClientApplication(int &argc, char **argv, const QStringL
 
 ClipboardClient::ClipboardClient(int &argc, char **argv, const QStringList &arguments, const QString &sessionName)
     : App(createClientApplication(argc, argv, arguments), sessionName)
+    , m_simpleCommand(arguments)
 {
-    App::installTranslator();
+    // Simple commands run without script engine and translations.
+    if ( !m_simpleCommand.isValid() )
+        App::installTranslator();
 
     // Start script after QCoreApplication::exec().
     auto timer = new QTimer(this);
@@ -114,9 +217,7 @@ void ClipboardClient::onConnectionFailed()
 
 void ClipboardClient::start(const QStringList &arguments)
 {
-    QJSEngine engine;
     ScriptableProxy scriptableProxy(nullptr, nullptr);
-    Scriptable scriptable(&engine, &scriptableProxy);
 
     const auto serverName = clipboardServerName();
     ClientSocket socket(serverName);
@@ -136,29 +237,99 @@ void ClipboardClient::start(const QStringList &arguments)
     connect( this, &ClipboardClient::inputDialogFinished,
              &scriptableProxy, &ScriptableProxy::setInputDialogResult );
 
-    connect( &socket, &ClientSocket::disconnected,
-             &scriptable, &Scriptable::abort );
     connect( &socket, &ClientSocket::disconnected,
              &scriptableProxy, &ScriptableProxy::clientDisconnected );
 
+    if ( !socket.start() )
+        return;
+
+    if ( arguments == QStringList(sessionPipeArgument) ) {
+        runSessionPipe(&socket, &scriptableProxy);
+        exit(0);
+    } else if ( m_simpleCommand.isValid() ) {
+        exit( m_simpleCommand.execute(&scriptableProxy) );
+    } else {
+        exit( runScript(arguments, &socket, &scriptableProxy) );
+    }
+}
+
+int ClipboardClient::runScript(
+        const QStringList &arguments, ClientSocket *socket, ScriptableProxy *scriptableProxy,
+        const QByteArray *input, QByteArray *output, QByteArray *errorOutput)
+{
+    QJSEngine engine;
+    Scriptable scriptable(&engine, scriptableProxy);
+
+    connect( socket, &ClientSocket::disconnected,
+             &scriptable, &Scriptable::abort );
+
     connect( this, &ClipboardClient::dataReceived,
              &scriptable, &Scriptable::dataReceived, Qt::QueuedConnection );
     connect( &scriptable, &Scriptable::receiveData,
-             &socket, [&]() {
-                socket.sendMessage(QByteArray(), CommandReceiveData);
+             socket, [socket]() {
+                socket->sendMessage(QByteArray(), CommandReceiveData);
              });
 
     bool hasActionId;
     auto actionId = qEnvironmentVariableIntValue("COPYQ_ACTION_ID", &hasActionId);
     const auto actionName = getTextData( qgetenv("COPYQ_ACTION_NAME") );
 
-    if ( socket.start() ) {
-        if (hasActionId)
-            scriptable.setActionId(actionId);
-        scriptable.setActionName(actionName);
+    if (hasActionId)
+        scriptable.setActionId(actionId);
+    scriptable.setActionName(actionName);
+
+    if (input)
+        scriptable.setInput(*input);
+    scriptable.setOutputBuffers(output, errorOutput);
+
+    const int exitCode = scriptable.executeArguments(arguments);
+    socket->disconnect(&scriptable);
+    return exitCode;
+}
+
+void ClipboardClient::runSessionPipe(ClientSocket *socket, ScriptableProxy *scriptableProxy)
+{
+    QFile in;
+    in.open(stdin, QIODevice::ReadOnly);
+    QFile out;
+    out.open(stdout, QIODevice::WriteOnly);
+
+    int lineNumber = 0;
+    while ( !wasClosed() ) {
+        const QByteArray line = in.readLine();
+        if ( line.isEmpty() )
+            break;
+
+        ++lineNumber;
+        if ( line.trimmed().isEmpty() )
+            continue;
+
+        SessionPipeRequest request;
+        QByteArray output;
+        QByteArray errorOutput;
+        int exitCode = CommandBadSyntax;
+        if ( parseSessionPipeRequest(line, lineNumber, &request, &errorOutput) ) {
+            const SimpleCommand simpleCommand(request.arguments);
+            if ( simpleCommand.isValid() ) {
+                exitCode = simpleCommand.execute(scriptableProxy, &output, &errorOutput);
+            } else {
+                exitCode = runScript(
+                    request.arguments, socket, scriptableProxy,
+                    &request.input, &output, &errorOutput);
+            }
+        }
 
-        const int exitCode = scriptable.executeArguments(arguments);
-        socket.disconnect(&scriptable);
-        exit(exitCode);
+        QJsonObject response;
+        response[QStringLiteral("id")] = request.id;
+        response[QStringLiteral("exitCode")] = exitCode;
+        // Binary output would be corrupted in JSON string.
+        const QString outputText = QString::fromUtf8(output);
+        if ( outputText.toUtf8() == output )
+            response[QStringLiteral("output")] = outputText;
+        else
+            response[QStringLiteral("outputBase64")] = QString::fromLatin1(output.toBase64());
+        response[QStringLiteral("errorOutput")] = QString::fromUtf8(errorOutput);
+        out.write( QJsonDocument(response).toJson(QJsonDocument::Compact) + '\n' );
+        out.flush();
     }
 }
@@ -5,9 +5,14 @@
 
 #include "app.h"
 
+#include "scriptable/simplecommand.h"
+
 #include <QObject>
 #include <QStringList>
 
+class ClientSocket;
+class ScriptableProxy;
+
 /**
  * Application client.
  *
@@ -35,6 +40,16 @@ private:
     void onConnectionFailed();
 
     void start(const QStringList &arguments);
+
+    int runScript(
+            const QStringList &arguments, ClientSocket *socket, ScriptableProxy *scriptableProxy,
+            const QByteArray *input = nullptr,
+            QByteArray *output = nullptr, QByteArray *errorOutput = nullptr);
+
+    /// Runs requests from standard input, one per line, over single connection.
+    void runSessionPipe(ClientSocket *socket, ScriptableProxy *scriptableProxy);
+
+    SimpleCommand m_simpleCommand;
 };
 
 #endif // CLIPBOARDCLIENT_H
@@ -8,6 +8,7 @@
 #include "common/log.h"
 #include "common/mimetypes.h"
 #include "common/textdata.h"
+#include "common/trace.h"
 #include "item/serialize.h"
 #include "platform/platformclipboard.h"
 
@@ -80,6 +81,11 @@ ClipboardMonitor::ClipboardMonitor(const QStringList &formats)
 
 void ClipboardMonitor::onClipboardChanged(ClipboardMode mode)
 {
+    // Monitor runs until server exits, so check if tracing was started meanwhile.
+    initTracing();
+    COPYQ_TRACE_DETAIL("ClipboardMonitor::onClipboardChanged",
+                       mode == ClipboardMode::Clipboard ? "clipboard" : "selection");
+
     QVariantMap data = m_clipboard->data(mode, m_formats);
     auto clipboardData = mode == ClipboardMode::Clipboard
             ? &m_clipboardData : &m_selectionData;
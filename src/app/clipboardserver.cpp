@@ -10,9 +10,10 @@
 #include "common/config.h"
 #include "common/display.h"
 #include "common/log.h"
+#include "common/metrics.h"
 #include "common/mimetypes.h"
 #include "common/shortcuts.h"
-#include "common/sleeptimer.h"
+#include "common/startupprofile.h"
 #include "common/timer.h"
 #include "common/textdata.h"
 #include "gui/actionhandler.h"
@@ -94,6 +95,7 @@ ClipboardServer::ClipboardServer(QApplication *app, const QString &sessionName)
 
     const QString serverName = clipboardServerName();
     m_server = new Server(serverName, this);
+    startupProfileMark("create server socket");
 
     if ( m_server->isListening() ) {
         App::installTranslator();
@@ -129,6 +131,7 @@ ClipboardServer::ClipboardServer(QApplication *app, const QString &sessionName)
     m_sharedData->notifications = new NotificationDaemon(this);
     m_sharedData->actions = new ActionHandler(m_sharedData->notifications, this);
     m_wnd = new MainWindow(m_sharedData);
+    startupProfileMark("create main window");
 
     connect( m_sharedData->notifications, &NotificationDaemon::notificationButtonClicked,
              this, &ClipboardServer::onNotificationButtonClicked );
@@ -136,6 +139,7 @@ ClipboardServer::ClipboardServer(QApplication *app, const QString &sessionName)
     m_sharedData->itemFactory->loadPlugins();
     if ( !m_sharedData->itemFactory->hasLoaders() )
         log("No plugins loaded", LogNote);
+    startupProfileMark("load plugins");
 
     connect( m_server, &Server::newConnection,
              this, &ClipboardServer::onClientNewConnection );
@@ -167,9 +171,11 @@ ClipboardServer::ClipboardServer(QApplication *app, const QString &sessionName)
         AppConfig appConfig;
         loadSettings(&appConfig);
     }
+    startupProfileMark("load settings");
 
     m_wnd->setCurrentTab(0);
     m_wnd->enterBrowseMode();
+    startupProfileMark("show first tab");
 
     qApp->installEventFilter(this);
 
@@ -189,8 +195,19 @@ ClipboardServer::ClipboardServer(QApplication *app, const QString &sessionName)
     });
 
     startMonitoring();
+    startupProfileMark("start clipboard monitor");
+
+    startMetricsDump();
 
     callback("onStart");
+    startupProfileMark("run onStart() callback");
+
+    if ( isStartupProfileEnabled() ) {
+        QTimer::singleShot(0, this, [](){
+            startupProfileMark("start event loop");
+            printStartupProfile();
+        });
+    }
 }
 
 ClipboardServer::~ClipboardServer()
@@ -210,6 +227,36 @@ ClipboardServer::~ClipboardServer()
     m_sharedData->itemFactory = nullptr;
 }
 
+void ClipboardServer::startMetricsDump()
+{
+    const QString fileName = QString::fromLocal8Bit( qgetenv("COPYQ_METRICS_FILE") );
+    if ( fileName.isEmpty() )
+        return;
+
+    enableMetrics();
+
+    bool ok;
+    int intervalMs = qgetenv("COPYQ_METRICS_INTERVAL_MS").toInt(&ok);
+    if (!ok || intervalMs <= 0)
+        intervalMs = 10000;
+
+    COPYQ_LOG( QStringLiteral("Writing metrics to \"%1\" every %2 ms")
+               .arg(fileName).arg(intervalMs) );
+
+    m_metricsDumpTimer.setInterval(intervalMs);
+    connect( &m_metricsDumpTimer, &QTimer::timeout, this, [this, fileName]() {
+        // Timer events (except the dump itself) wake up otherwise idle server.
+        const qint64 elapsedMs = qMax<qint64>(1, m_metricsDumpElapsed.restart());
+        setMetricGauge("server_timer_wakeups_per_minute", m_timerEventCount * 60000 / elapsedMs);
+        m_timerEventCount = 0;
+
+        if ( !writeMetricsFile(fileName) )
+            log( QStringLiteral("Failed to write metrics to \"%1\"").arg(fileName), LogWarning );
+    });
+    m_metricsDumpElapsed.start();
+    m_metricsDumpTimer.start();
+}
+
 void ClipboardServer::stopMonitoring()
 {
     if (!m_monitor)
@@ -368,14 +415,14 @@ bool ClipboardServer::askToQuit()
         messageBox.addButton(tr("Exit Anyway"), QMessageBox::AcceptRole);
 
         // Close the message box automatically after all running commands finish.
-        QTimer timerCheckRunningCommands;
-        timerCheckRunningCommands.setInterval(1000);
-        connect( &timerCheckRunningCommands, &QTimer::timeout,
-                 this, [&]() {
-                    if ( !hasRunningCommands() )
-                        messageBox.accept();
-                 });
-        timerCheckRunningCommands.start();
+        const auto acceptIfFinished = [&]() {
+            if ( !hasRunningCommands() )
+                messageBox.accept();
+        };
+        connect( m_sharedData->actions, &ActionHandler::actionFinished,
+                 &messageBox, acceptIfFinished );
+        connect( this, &ClipboardServer::clientRemoved,
+                 &messageBox, acceptIfFinished );
 
         return messageBox.exec() == QMessageBox::Accepted;
     }
@@ -415,8 +462,12 @@ void ClipboardServer::terminateClients(int waitMs)
 
 void ClipboardServer::waitForClientsToFinish(int waitMs)
 {
-    SleepTimer t(waitMs);
-    while ( !m_clients.isEmpty() && t.sleep() ) {}
+    // Wake up only on new events (e.g. client disconnected) or on timeout.
+    QTimer timeout;
+    timeout.setSingleShot(true);
+    timeout.start(waitMs);
+    while ( !m_clients.isEmpty() && timeout.isActive() )
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
 }
 
 void ClipboardServer::waitForCallbackToFinish()
@@ -519,13 +570,19 @@ void ClipboardServer::onClientMessageReceived(
 
 void ClipboardServer::onClientDisconnected(ClientSocketId clientId)
 {
-    m_clients.remove(clientId);
+    removeClient(clientId);
 }
 
 void ClipboardServer::onClientConnectionFailed(ClientSocketId clientId)
 {
     log("Client connection failed", LogWarning);
-    m_clients.remove(clientId);
+    removeClient(clientId);
+}
+
+void ClipboardServer::removeClient(ClientSocketId clientId)
+{
+    if ( m_clients.remove(clientId) > 0 )
+        emit clientRemoved();
 }
 
 void ClipboardServer::onMonitorFinished()
@@ -579,6 +636,14 @@ bool ClipboardServer::eventFilter(QObject *object, QEvent *ev)
 {
     const QEvent::Type type = ev->type();
 
+    if (type == QEvent::Timer) {
+        if ( m_metricsDumpElapsed.isValid() && object != &m_metricsDumpTimer ) {
+            ++m_timerEventCount;
+            addMetricCount("server_timer_wakeups");
+        }
+        return false;
+    }
+
     if ( type == QEvent::KeyPress
          || type == QEvent::Shortcut
          || type == QEvent::ShortcutOverride )
@@ -676,6 +741,8 @@ void ClipboardServer::loadSettings(AppConfig *appConfig)
     m_sharedData->showSimpleItems = appConfig->option<Config::show_simple_items>();
     m_sharedData->numberSearch = appConfig->option<Config::number_search>();
     m_sharedData->minutesToExpire = appConfig->option<Config::expire_tab>();
+    m_sharedData->tabMemoryLimitBytes =
+        static_cast<qint64>(appConfig->option<Config::tab_memory_limit_mb>()) * 1024 * 1024;
     m_sharedData->saveDelayMsOnItemAdded = appConfig->option<Config::save_delay_ms_on_item_added>();
     m_sharedData->saveDelayMsOnItemModified = appConfig->option<Config::save_delay_ms_on_item_modified>();
     m_sharedData->saveDelayMsOnItemRemoved = appConfig->option<Config::save_delay_ms_on_item_removed>();
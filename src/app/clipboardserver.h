@@ -10,6 +10,7 @@
 #include "common/clientsocket.h"
 #include "gui/clipboardbrowsershared.h"
 
+#include <QElapsedTimer>
 #include <QMap>
 #include <QPointer>
 #include <QTimer>
@@ -60,6 +61,7 @@ public:
 
 signals:
     void closeClients();
+    void clientRemoved();
 
 protected:
     bool eventFilter(QObject *object, QEvent *ev) override;
@@ -109,15 +111,21 @@ private:
 
     void terminateClients(int waitMs);
 
+    /// Processes events until all clients disconnect or the time runs out.
     void waitForClientsToFinish(int waitMs);
     void waitForCallbackToFinish();
 
     void callback(const QString &scriptFunction);
 
+    void removeClient(ClientSocketId clientId);
+
     ClientSocketPtr findClient(int actionId);
 
     void sendActionData(int actionId, const QByteArray &bytes);
 
+    /// Periodically writes metrics to file set in COPYQ_METRICS_FILE environment variable.
+    void startMetricsDump();
+
     Server *m_server = nullptr;
     MainWindow* m_wnd = nullptr;
     QPointer<Action> m_monitor;
@@ -135,6 +143,9 @@ private:
 
     QMap<int, QByteArray> m_actionDataToSend;
     QTimer m_timerClearUnsentActionData;
+    QTimer m_metricsDumpTimer;
+    QElapsedTimer m_metricsDumpElapsed;
+    qint64 m_timerEventCount = 0;
 
     struct ClientData {
         ClientData() = default;
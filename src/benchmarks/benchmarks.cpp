@@ -0,0 +1,374 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "benchmarks.h"
+
+#include "common/mimetypes.h"
+#include "common/textdata.h"
+#include "gui/iconfactory.h"
+#include "gui/icons.h"
+#include "item/clipboardmodel.h"
+#include "item/itemfilter.h"
+#include "item/serialize.h"
+
+#include <QApplication>
+#include <QBuffer>
+#include <QDataStream>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMenu>
+#include <QRegularExpression>
+#include <QStyle>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QXmlStreamReader>
+
+#include <cstdio>
+
+namespace {
+
+const QList<int> itemCounts = {1000, 10000, 100000};
+
+const QString searchText = QStringLiteral("Item 999 copied");
+
+const QList<ushort> menuIconIds = {
+    IconPaste, IconCopy, IconMagnifyingGlass, IconGear, IconStar, IconTag, IconTrash, IconPen};
+
+void addItemCountRows()
+{
+    QTest::addColumn<int>("itemCount");
+    for (const int itemCount : itemCounts)
+        QTest::newRow( QByteArray::number(itemCount) ) << itemCount;
+}
+
+QVariantMap createItemData(int i)
+{
+    const QString text = QStringLiteral("Item %1 copied from a window (řčšž ÁÉÍ)\nsecond line").arg(i);
+    QVariantMap data;
+    data.insert(mimeText, text.toUtf8());
+    data.insert(mimeHtml, QStringLiteral("<b>%1</b>").arg(text).toUtf8());
+    data.insert(mimeWindowTitle, QByteArrayLiteral("Window Title"));
+    return data;
+}
+
+QList<QVariantMap> createItems(int count)
+{
+    QList<QVariantMap> items;
+    items.reserve(count);
+    for (int i = 0; i < count; ++i)
+        items.append( createItemData(i) );
+    return items;
+}
+
+QStringList createTexts(int count)
+{
+    QStringList texts;
+    texts.reserve(count);
+    for (int i = 0; i < count; ++i)
+        texts.append( getTextData(createItemData(i)) );
+    return texts;
+}
+
+int countMatching(const ItemFilter &filter, const QStringList &texts)
+{
+    int count = 0;
+    for (const auto &text : texts) {
+        if ( filter.matches(text) )
+            ++count;
+    }
+    return count;
+}
+
+QJsonArray benchmarkResultsFromXml(QIODevice *device)
+{
+    QJsonArray results;
+    QString testFunction;
+    QXmlStreamReader xml(device);
+    while ( !xml.atEnd() ) {
+        xml.readNext();
+        if ( !xml.isStartElement() )
+            continue;
+
+        const auto attributes = xml.attributes();
+        if ( xml.name() == QLatin1String("TestFunction") ) {
+            testFunction = attributes.value("name").toString();
+        } else if ( xml.name() == QLatin1String("BenchmarkResult") ) {
+            results.append(QJsonObject{
+                {"name", testFunction},
+                {"tag", attributes.value("tag").toString()},
+                {"metric", attributes.value("metric").toString()},
+                {"value", attributes.value("value").toDouble()},
+                {"iterations", attributes.value("iterations").toInt()},
+            });
+        }
+    }
+    return results;
+}
+
+bool writeJsonResults(const QString &xmlFileName, const QString &jsonFileName)
+{
+    QFile xmlFile(xmlFileName);
+    if ( !xmlFile.open(QIODevice::ReadOnly) ) {
+        fprintf(stderr, "Failed to read benchmark results: %s\n", qPrintable(xmlFile.errorString()));
+        return false;
+    }
+
+    const QJsonObject root{
+        {"qtVersion", QString::fromLatin1(qVersion())},
+        {"results", benchmarkResultsFromXml(&xmlFile)},
+    };
+
+    QFile jsonFile(jsonFileName);
+    if ( !jsonFile.open(QIODevice::WriteOnly) ) {
+        fprintf(stderr, "Failed to write benchmark results: %s\n", qPrintable(jsonFile.errorString()));
+        return false;
+    }
+
+    jsonFile.write( QJsonDocument(root).toJson() );
+    return true;
+}
+
+} // namespace
+
+void Benchmarks::serializeItems_data()
+{
+    addItemCountRows();
+}
+
+void Benchmarks::serializeItems()
+{
+    QFETCH(int, itemCount);
+
+    ClipboardModel model;
+    model.insertItems(createItems(itemCount), 0);
+
+    QBENCHMARK {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        QVERIFY( serializeData(model, &buffer) );
+    }
+}
+
+void Benchmarks::deserializeItems_data()
+{
+    addItemCountRows();
+}
+
+void Benchmarks::deserializeItems()
+{
+    QFETCH(int, itemCount);
+
+    QByteArray bytes;
+    {
+        ClipboardModel model;
+        model.insertItems(createItems(itemCount), 0);
+        QBuffer buffer(&bytes);
+        buffer.open(QIODevice::WriteOnly);
+        QVERIFY( serializeData(model, &buffer) );
+    }
+
+    QBENCHMARK {
+        ClipboardModel model;
+        QBuffer buffer(&bytes);
+        buffer.open(QIODevice::ReadOnly);
+        QVERIFY( deserializeData(&model, &buffer, itemCount) );
+        QCOMPARE( model.rowCount(), itemCount );
+    }
+}
+
+void Benchmarks::modelInsertItems_data()
+{
+    addItemCountRows();
+}
+
+void Benchmarks::modelInsertItems()
+{
+    QFETCH(int, itemCount);
+
+    const QList<QVariantMap> items = createItems(itemCount);
+
+    QBENCHMARK {
+        ClipboardModel model;
+        for (const auto &data : items)
+            model.insertItem(data, 0);
+    }
+}
+
+void Benchmarks::modelMoveItems_data()
+{
+    addItemCountRows();
+}
+
+void Benchmarks::modelMoveItems()
+{
+    QFETCH(int, itemCount);
+
+    ClipboardModel model;
+    model.insertItems(createItems(itemCount), 0);
+
+    // Move last item to top, similar to activating an old item.
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i)
+            model.moveRows(QModelIndex(), itemCount - 1, 1, QModelIndex(), 0);
+    }
+}
+
+void Benchmarks::modelFindItem_data()
+{
+    addItemCountRows();
+}
+
+void Benchmarks::modelFindItem()
+{
+    QFETCH(int, itemCount);
+
+    ClipboardModel model;
+    model.insertItems(createItems(itemCount), 0);
+
+    // Worst case: item is missing.
+    const uint missingHash = hash( createItemData(-1) );
+
+    QBENCHMARK {
+        QCOMPARE( model.findItem(missingHash), -1 );
+    }
+}
+
+void Benchmarks::filterFixedStrings_data()
+{
+    addItemCountRows();
+}
+
+void Benchmarks::filterFixedStrings()
+{
+    QFETCH(int, itemCount);
+
+    const QStringList texts = createTexts(itemCount);
+    const auto filter = createItemFilterFixedStrings(searchText, Qt::CaseInsensitive);
+
+    QBENCHMARK {
+        QVERIFY( countMatching(*filter, texts) > 0 );
+    }
+}
+
+void Benchmarks::filterRegExp_data()
+{
+    addItemCountRows();
+}
+
+void Benchmarks::filterRegExp()
+{
+    QFETCH(int, itemCount);
+
+    const QStringList texts = createTexts(itemCount);
+    const QString pattern = QStringLiteral("item \\d*99 copied");
+    const auto filter = createItemFilterRegExp(
+        QRegularExpression(pattern, QRegularExpression::CaseInsensitiveOption), pattern);
+
+    QBENCHMARK {
+        QVERIFY( countMatching(*filter, texts) > 0 );
+    }
+}
+
+void Benchmarks::accentsRemoved_data()
+{
+    addItemCountRows();
+}
+
+void Benchmarks::accentsRemoved()
+{
+    QFETCH(int, itemCount);
+
+    const QStringList texts = createTexts(itemCount);
+
+    QBENCHMARK {
+        for (const auto &text : texts)
+            ::accentsRemoved(text);
+    }
+}
+
+void Benchmarks::hashDataMap_data()
+{
+    addItemCountRows();
+}
+
+void Benchmarks::hashDataMap()
+{
+    QFETCH(int, itemCount);
+
+    const QList<QVariantMap> items = createItems(itemCount);
+
+    QBENCHMARK {
+        uint seed = 0;
+        for (const auto &data : items)
+            seed ^= hash(data);
+        Q_UNUSED(seed)
+    }
+}
+
+void Benchmarks::menuRebuild_data()
+{
+    QTest::addColumn<int>("actionCount");
+    for (const int actionCount : {20, 200})
+        QTest::newRow( QByteArray::number(actionCount) ) << actionCount;
+}
+
+void Benchmarks::menuRebuild()
+{
+    QFETCH(int, actionCount);
+
+    QMenu menu;
+    setActivePaintDevice(&menu);
+    const int extent = menu.style()->pixelMetric(QStyle::PM_SmallIconSize, nullptr, &menu);
+    const QSize iconSize(extent, extent);
+
+    // Similar to tray menu with items and commands, some of them tagged.
+    QBENCHMARK {
+        menu.clear();
+        for (int i = 0; i < actionCount; ++i) {
+            const QString iconName( QChar(menuIconIds[i % menuIconIds.size()]) );
+            const QString tag = (i % 3 == 0) ? QString::number(i % 10) : QString();
+            const QIcon icon = iconFromFile(iconName, tag, Qt::red);
+            menu.addAction( icon, QStringLiteral("Item %1").arg(i) );
+            icon.pixmap(iconSize, QIcon::Normal);
+            icon.pixmap(iconSize, QIcon::Selected);
+        }
+    }
+
+    setActivePaintDevice(nullptr);
+}
+
+int main(int argc, char *argv[])
+{
+    // Widgets are only rendered off-screen.
+    if ( qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM") )
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+
+    QStringList args = app.arguments();
+    QString jsonFileName;
+    const int jsonArgIndex = args.indexOf("--json");
+    if (jsonArgIndex != -1) {
+        jsonFileName = args.value(jsonArgIndex + 1);
+        if ( jsonFileName.isEmpty() ) {
+            fprintf(stderr, "Expected file name after --json\n");
+            return 2;
+        }
+        args.removeAt(jsonArgIndex);
+        args.removeAt(jsonArgIndex);
+    }
+
+    QTemporaryDir tmpDir;
+    const QString xmlFileName = tmpDir.filePath("results.xml");
+    if ( !jsonFileName.isEmpty() )
+        args << "-o" << xmlFileName + ",xml" << "-o" << "-,txt";
+
+    Benchmarks benchmarks;
+    const int exitCode = QTest::qExec(&benchmarks, args);
+
+    if ( !jsonFileName.isEmpty() && !writeJsonResults(xmlFileName, jsonFileName) )
+        return qMax(exitCode, 1);
+
+    return exitCode;
+}
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <QObject>
+
+/**
+ * Benchmarks for hot paths (serialization, model, filtering, icons).
+ *
+ * Run "copyq-benchmarks --json results.json" to store results in JSON format.
+ */
+class Benchmarks final : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void serializeItems_data();
+    void serializeItems();
+
+    void deserializeItems_data();
+    void deserializeItems();
+
+    void modelInsertItems_data();
+    void modelInsertItems();
+
+    void modelMoveItems_data();
+    void modelMoveItems();
+
+    void modelFindItem_data();
+    void modelFindItem();
+
+    void filterFixedStrings_data();
+    void filterFixedStrings();
+
+    void filterRegExp_data();
+    void filterRegExp();
+
+    void accentsRemoved_data();
+    void accentsRemoved();
+
+    void hashDataMap_data();
+    void hashDataMap();
+
+    void menuRebuild_data();
+    void menuRebuild();
+};
+
+#endif // BENCHMARKS_H
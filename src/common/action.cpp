@@ -15,8 +15,16 @@
 #include <QRegularExpression>
 #include <QTimer>
 
+#include <algorithm>
+
 namespace {
 
+/// Maximum number of input bytes buffered for writing to a process.
+constexpr qint64 inputWriteBufferSize = 1024 * 1024;
+
+/// Maximum number of input bytes copied to the process write buffer at once.
+constexpr qint64 inputWriteChunkSize = 64 * 1024;
+
 void startProcess(QProcess *process, const QStringList &args, QIODevice::OpenModeFlag mode)
 {
     QString executable = args.value(0);
@@ -219,13 +227,25 @@ void Action::setCommand(const QStringList &arguments)
     m_cmds.append(QList<QStringList>() << arguments);
 }
 
+QByteArray Action::input() const
+{
+    if ( m_input.size() == 1 )
+        return m_input.first();
+
+    QByteArray bytes;
+    for (const auto &chunk : m_input)
+        bytes.append(chunk);
+    return bytes;
+}
+
 void Action::setInputWithFormat(const QVariantMap &data, const QString &inputFormat)
 {
+    m_input.clear();
     if (inputFormat == mimeItems) {
-        m_input = serializeData(data);
+        serializeData(data, &m_input);
         m_inputFormats = data.keys();
     } else {
-        m_input = data.value(inputFormat).toByteArray();
+        m_input.append( data.value(inputFormat).toByteArray() );
         m_inputFormats = QStringList(inputFormat);
     }
 }
@@ -278,7 +298,11 @@ void Action::start()
     connect( firstProcess, &QProcess::bytesWritten,
              this, &Action::onBytesWritten, Qt::QueuedConnection );
 
-    const bool needWrite = !m_input.isEmpty();
+    m_inputChunk = 0;
+    m_inputChunkOffset = 0;
+    const bool needWrite = std::any_of(
+        m_input.constBegin(), m_input.constEnd(),
+        [](const QByteArray &chunk) { return !chunk.isEmpty(); });
     if (m_processes.size() == 1) {
         const auto mode =
                 (needWrite && m_readOutput) ? QIODevice::ReadWrite
@@ -400,16 +424,29 @@ void Action::writeInput()
 
     QProcess *p = m_processes.front();
 
-    if (m_input.isEmpty())
+    // Keep the write buffer small instead of copying whole input at once.
+    while ( m_inputChunk < m_input.size() && p->bytesToWrite() < inputWriteBufferSize ) {
+        const QByteArray &chunk = m_input[m_inputChunk];
+        const qint64 size = qMin(inputWriteChunkSize, static_cast<qint64>(chunk.size()) - m_inputChunkOffset);
+        if ( size > 0 && p->write(chunk.constData() + m_inputChunkOffset, size) != size ) {
+            m_inputChunk = m_input.size();
+            break;
+        }
+
+        m_inputChunkOffset += size;
+        if (m_inputChunkOffset >= chunk.size()) {
+            ++m_inputChunk;
+            m_inputChunkOffset = 0;
+        }
+    }
+
+    if ( m_inputChunk >= m_input.size() )
         p->closeWriteChannel();
-    else
-        p->write(m_input);
 }
 
 void Action::onBytesWritten()
 {
-    if ( !m_processes.empty() )
-        m_processes.front()->closeWriteChannel();
+    writeInput();
 }
 
 void Action::terminate()
@@ -7,6 +7,7 @@
 #include <QProcess>
 #include <QStringList>
 #include <QVariantMap>
+#include <QVector>
 
 #include <vector>
 
@@ -49,8 +50,11 @@ public:
     const QList<QList<QStringList>> &command() const { return m_cmds; }
 
     /** Return input. */
-    const QByteArray &input() const { return m_input; }
-    void setInput(const QByteArray &input) { m_input = input; }
+    QByteArray input() const;
+    void setInput(const QByteArray &input) { m_input = {input}; }
+
+    /** Append data to input without copying the current input. */
+    void appendInput(const QByteArray &input) { m_input.append(input); }
 
     /** Set data for input and input format. */
     void setInputWithFormat(const QVariantMap &data, const QString &inputFormat);
@@ -112,7 +116,10 @@ private:
     void closeSubCommands();
     void finish();
 
-    QByteArray m_input;
+    /// Input chunks, written to the first process incrementally.
+    QVector<QByteArray> m_input;
+    int m_inputChunk = 0;
+    qint64 m_inputChunkOffset = 0;
     QList< QList<QStringList> > m_cmds;
     QStringList m_inputFormats;
     QString m_workingDirectoryPath;
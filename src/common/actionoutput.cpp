@@ -6,12 +6,15 @@
 #include "common/contenttype.h"
 #include "common/mimetypes.h"
 #include "common/textdata.h"
+#include "common/timer.h"
 #include "gui/clipboardbrowser.h"
 #include "gui/mainwindow.h"
 #include "item/serialize.h"
 
 #include <QObject>
 #include <QPersistentModelIndex>
+#include <QRegularExpression>
+#include <QTimer>
 
 namespace {
 
@@ -26,6 +29,30 @@ void connectActionOutput(Action *action, ActionOutput *actionOutput)
     action->setReadOutput(true);
 }
 
+/// Maximum number of output items added to a tab at once.
+constexpr int outputItemBatchSize = 1000;
+
+/// Maximum number of output items waiting to be added before output processing blocks.
+constexpr int maxPendingOutputItems = 10 * outputItemBatchSize;
+
+/// Returns size of bytes without incomplete UTF-8 sequence at the end.
+int completeUtf8Size(const QByteArray &bytes)
+{
+    const int size = bytes.size();
+    for (int i = size - 1; i >= 0 && i >= size - 4; --i) {
+        const auto c = static_cast<uchar>(bytes[i]);
+        if ( (c & 0xC0) == 0x80 )
+            continue;
+
+        const int length = (c & 0xE0) == 0xC0 ? 2
+            : (c & 0xF0) == 0xE0 ? 3
+            : (c & 0xF8) == 0xF0 ? 4
+            : 1;
+        return i + length <= size ? size : i;
+    }
+    return size;
+}
+
 class ActionOutputItems final : public QObject
 {
 public:
@@ -42,36 +69,112 @@ public:
         , m_sep(itemSeparator)
     {
         connectActionOutput(action, this);
+        initSingleShotTimer(&m_timerAddItems, 0, this, &ActionOutputItems::addItemBatch);
     }
 
     void onActionOutput(const QByteArray &output)
     {
-        m_lastOutput.append( getTextData(output) );
-        auto items = m_lastOutput.split(m_sep);
-        m_lastOutput = items.takeLast();
-        if ( !items.isEmpty() )
-            addItems(items);
+        m_pendingBytes.append(output);
+        const int size = completeUtf8Size(m_pendingBytes);
+        m_lastOutput.append( QString::fromUtf8(m_pendingBytes.constData(), size) );
+        m_pendingBytes.remove(0, size);
+
+        splitOutput(false);
+
+        while (m_items.size() > maxPendingOutputItems)
+            addItemBatch();
     }
 
     void onActionFinished(Action *)
     {
-        if ( !m_lastOutput.isEmpty() )
-            addItems(QStringList() << m_lastOutput);
+        if ( !m_pendingBytes.isEmpty() ) {
+            m_lastOutput.append( getTextData(m_pendingBytes) );
+            m_pendingBytes.clear();
+        }
+
+        splitOutput(true);
+        if ( !m_lastOutput.isEmpty() ) {
+            m_items.append(m_lastOutput);
+            m_lastOutput.clear();
+        }
+
+        // Keep adding remaining items after the action is deleted.
+        m_finished = true;
+        setParent(m_wnd);
+        if ( m_items.isEmpty() )
+            deleteLater();
     }
 
 private:
-    void addItems(const QStringList &items)
+    /**
+     * Splits only newly received text.
+     *
+     * Search continues from the start of a separator that may be completed
+     * by the next output (partial match at the end), so separators of any
+     * length spanning output chunks are found.
+     */
+    void splitOutput(bool finished)
     {
-        ClipboardBrowser *c = m_tab.isEmpty() ? m_wnd->browser() : m_wnd->tab(m_tab);
-        for (const auto &item : items)
-            c->add( createDataMap(m_outputFormat, item) );
+        int itemStart = 0;
+        int resumeFrom = -1;
+        const auto matchType = finished
+            ? QRegularExpression::NormalMatch
+            : QRegularExpression::PartialPreferFirstMatch;
+        auto it = m_sep.globalMatch(m_lastOutput, m_searchFrom, matchType);
+        while ( it.hasNext() ) {
+            const auto match = it.next();
+
+            // Separator at the end can continue in the next output.
+            if ( !finished && (match.hasPartialMatch() || match.capturedEnd() == m_lastOutput.size()) ) {
+                resumeFrom = static_cast<int>(match.capturedStart());
+                break;
+            }
+
+            m_items.append( m_lastOutput.mid(itemStart, match.capturedStart() - itemStart) );
+            itemStart = static_cast<int>(match.capturedEnd());
+        }
+
+        if (resumeFrom == -1)
+            resumeFrom = static_cast<int>(m_lastOutput.size());
+
+        m_lastOutput.remove(0, itemStart);
+        m_searchFrom = resumeFrom - itemStart;
+
+        if ( !m_items.isEmpty() )
+            m_timerAddItems.start();
+    }
+
+    void addItemBatch()
+    {
+        const int count = qMin(outputItemBatchSize, static_cast<int>(m_items.size()));
+        if (count > 0) {
+            // Last item should be on top as if each item was added separately.
+            QList<QVariantMap> dataList;
+            dataList.reserve(count);
+            for (int i = count - 1; i >= 0; --i)
+                dataList.append( createDataMap(m_outputFormat, m_items[i]) );
+            m_items.erase(m_items.begin(), m_items.begin() + count);
+
+            ClipboardBrowser *c = m_tab.isEmpty() ? m_wnd->browser() : m_wnd->tab(m_tab);
+            c->addItems(dataList);
+        }
+
+        if ( !m_items.isEmpty() )
+            m_timerAddItems.start();
+        else if (m_finished)
+            deleteLater();
     }
 
     MainWindow *m_wnd;
     QString m_outputFormat;
     QString m_tab;
     QRegularExpression m_sep;
+    QByteArray m_pendingBytes;
     QString m_lastOutput;
+    int m_searchFrom = 0;
+    QStringList m_items;
+    QTimer m_timerAddItems;
+    bool m_finished = false;
 };
 
 class ActionOutputItem final : public QObject
@@ -4,6 +4,7 @@
 
 #include "common/action.h"
 #include "common/actionhandlerenums.h"
+#include "common/metrics.h"
 
 #include <QColor>
 
@@ -86,6 +87,7 @@ void ActionTableModel::actionFinished(Action *action)
     const int row = rowFor(action);
     ActionData &data = actionData(row);
     data.finished = data.started.msecsTo(QDateTime::currentDateTime());
+    addMetricLatency("command_runtime_ms", data.finished);
     for (const int column : { ActionHandlerColumn::finished, ActionHandlerColumn::status }) {
         const auto index = this->index(row, column);
         emit dataChanged(index, index);
@@ -382,6 +382,15 @@ struct save_delay_ms_on_item_edited : Config<int> {
     }
 };
 
+struct tab_memory_limit_mb : Config<int> {
+    static QString name() { return "tab_memory_limit_mb"; }
+    static Value defaultValue() { return 0; }
+    static const char *description() {
+        return "Unload least recently used tabs if estimated memory used by loaded tabs"
+               " exceeds this limit in MiB (0 to disable)";
+    }
+};
+
 struct save_on_app_deactivated : Config<bool> {
     static QString name() { return "save_on_app_deactivated"; }
     static Value defaultValue() { return true; }
@@ -4,7 +4,9 @@
 
 #include "common/client_server.h"
 #include "common/log.h"
+#include "common/metrics.h"
 #include "common/sleeptimer.h"
+#include "common/trace.h"
 
 #include <QDataStream>
 
@@ -165,6 +167,7 @@ bool ClientSocket::start()
 
 void ClientSocket::sendMessage(const QByteArray &message, int messageCode)
 {
+    COPYQ_TRACE("ClientSocket::sendMessage");
     SOCKET_LOG( QString("Sending message to client (exit code: %1).").arg(messageCode) );
 
     if (!m_socket) {
@@ -177,10 +180,13 @@ void ClientSocket::sendMessage(const QByteArray &message, int messageCode)
         out.setVersion(QDataStream::Qt_5_0);
         out << static_cast<qint32>(messageCode);
         out.writeRawData( message.constData(), message.length() );
-        if ( writeMessage(m_socket, msg) )
+        if ( writeMessage(m_socket, msg) ) {
+            addMetricCount("ipc_messages_sent");
+            addMetricCount("ipc_bytes_sent", msg.size());
             SOCKET_LOG("Message sent to client.");
-        else
+        } else {
             SOCKET_LOG("Failed to send message to client!");
+        }
     }
 }
 
@@ -201,6 +207,7 @@ void ClientSocket::onReadyRead()
 
     const qint64 available = m_socket->bytesAvailable();
     m_message.append( m_socket->read(available) );
+    addMetricCount("ipc_bytes_received", available);
 
     while ( !m_message.isEmpty() ) {
         if (!m_hasMessageLength) {
@@ -249,6 +256,8 @@ void ClientSocket::onReadyRead()
         m_hasMessageLength = false;
         m_message = m_message.mid(length);
 
+        addMetricCount("ipc_messages_received");
+        COPYQ_TRACE("ClientSocket::messageReceived");
         emit messageReceived(msg, messageCode, id());
     }
 }
@@ -5,16 +5,29 @@
 #include "common/command.h"
 #include "common/common.h"
 #include "common/config.h"
+#include "common/log.h"
 #include "common/mimetypes.h"
 #include "common/settings.h"
 #include "common/temporarysettings.h"
 #include "common/textdata.h"
+#include "common/version.h"
 
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
 #include <QSettings>
 #include <QString>
 
 namespace {
 
+const QByteArray scriptCommandsCacheHeader("CopyQ script commands v1");
+
+QString scriptCommandsCachePath()
+{
+    return getConfigurationFilePath("-script-commands.dat");
+}
+
 void normalizeLineBreaks(QString &cmd)
 {
     if (cmd.startsWith("\n    ")) {
@@ -155,6 +168,60 @@ void saveCommands(const Commands &commands)
     saveCommands(commands, &settings);
 }
 
+void saveScriptCommandsCache(const Commands &scriptCommands)
+{
+    QByteArray bytes;
+    {
+        QDataStream stream(&bytes, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_5_0);
+        stream << scriptCommands;
+    }
+
+    QSaveFile file( scriptCommandsCachePath() );
+    if ( !file.open(QIODevice::WriteOnly) ) {
+        log( QStringLiteral("Failed to cache script commands: %1").arg(file.errorString()), LogWarning );
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << scriptCommandsCacheHeader
+        << QString(versionString)
+        << QCryptographicHash::hash(bytes, QCryptographicHash::Sha1)
+        << bytes;
+
+    if ( out.status() != QDataStream::Ok || !file.commit() )
+        log( QStringLiteral("Failed to cache script commands: %1").arg(file.errorString()), LogWarning );
+}
+
+bool loadScriptCommandsCache(Commands *scriptCommands)
+{
+    QFile file( scriptCommandsCachePath() );
+    if ( !file.open(QIODevice::ReadOnly) )
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+    QByteArray header;
+    QString version;
+    QByteArray hash;
+    QByteArray bytes;
+    in >> header >> version >> hash >> bytes;
+    // Command serialization can change between versions.
+    if ( in.status() != QDataStream::Ok
+         || header != scriptCommandsCacheHeader
+         || version != versionString
+         || hash != QCryptographicHash::hash(bytes, QCryptographicHash::Sha1) )
+    {
+        return false;
+    }
+
+    QDataStream stream(bytes);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream >> *scriptCommands;
+    return stream.status() == QDataStream::Ok;
+}
+
 Commands loadCommands(QSettings *settings)
 {
     Commands commands;
@@ -17,6 +17,11 @@ void saveCommands(const Commands &commands);
 Commands loadCommands(QSettings *settings);
 void saveCommands(const Commands &commands, QSettings *settings);
 
+/// Stores script commands so clients can load them without asking server.
+void saveScriptCommandsCache(const Commands &scriptCommands);
+/// Returns false if script commands were not cached or the cache is corrupted.
+bool loadScriptCommandsCache(Commands *scriptCommands);
+
 Commands importCommandsFromFile(const QString &filePath);
 Commands importCommandsFromText(const QString &commands);
 QString exportCommands(const Commands &commands);
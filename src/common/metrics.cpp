@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "metrics.h"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QString>
+
+#include <array>
+#include <atomic>
+
+namespace {
+
+// Upper bounds of histogram buckets in milliseconds (last bucket is unbounded).
+constexpr std::array<qint64, 12> histogramBuckets{
+    1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000};
+
+struct Histogram {
+    std::array<qint64, histogramBuckets.size() + 1> counts{};
+    qint64 count = 0;
+    qint64 sum = 0;
+    qint64 max = 0;
+};
+
+struct Registry {
+    Registry() { uptime.start(); }
+
+    QMutex mutex;
+    QElapsedTimer uptime;
+    QHash<QByteArray, qint64> counters;
+    QHash<QByteArray, qint64> gauges;
+    QHash<QByteArray, QHash<QString, qint64>> labeledGauges;
+    QHash<QByteArray, Histogram> histograms;
+};
+
+Registry &registry()
+{
+    static Registry registry;
+    return registry;
+}
+
+std::atomic<bool> metricsEnabled{false};
+
+// Estimates percentile as upper bound of the bucket containing it.
+qint64 histogramPercentile(const Histogram &histogram, int percent)
+{
+    const qint64 rank = (histogram.count * percent + 99) / 100;
+    qint64 seen = 0;
+    for (size_t i = 0; i < histogramBuckets.size(); ++i) {
+        seen += histogram.counts[i];
+        if (seen >= rank)
+            return qMin(histogramBuckets[i], histogram.max);
+    }
+    return histogram.max;
+}
+
+QJsonObject histogramToJson(const Histogram &histogram)
+{
+    QJsonObject buckets;
+    for (size_t i = 0; i < histogramBuckets.size(); ++i)
+        buckets.insert( QString::number(histogramBuckets[i]), histogram.counts[i] );
+    buckets.insert( QStringLiteral("inf"), histogram.counts.back() );
+
+    return QJsonObject{
+        {"count", histogram.count},
+        {"sum", histogram.sum},
+        {"max", histogram.max},
+        {"p50", histogramPercentile(histogram, 50)},
+        {"p99", histogramPercentile(histogram, 99)},
+        {"buckets", buckets},
+    };
+}
+
+} // namespace
+
+void addMetricCount(const char *name, qint64 value)
+{
+    auto &r = registry();
+    QMutexLocker lock(&r.mutex);
+    r.counters[name] += value;
+}
+
+void setMetricGauge(const char *name, qint64 value)
+{
+    auto &r = registry();
+    QMutexLocker lock(&r.mutex);
+    r.gauges[name] = value;
+}
+
+void setMetricGauge(const char *name, const QString &label, qint64 value)
+{
+    auto &r = registry();
+    QMutexLocker lock(&r.mutex);
+    r.labeledGauges[name][label] = value;
+}
+
+void removeMetricGaugeLabel(const char *name, const QString &label)
+{
+    auto &r = registry();
+    QMutexLocker lock(&r.mutex);
+    const auto it = r.labeledGauges.find(name);
+    if ( it != r.labeledGauges.end() )
+        it->remove(label);
+}
+
+void addMetricLatency(const char *name, qint64 milliseconds)
+{
+    auto &r = registry();
+    QMutexLocker lock(&r.mutex);
+    auto &histogram = r.histograms[name];
+
+    size_t bucket = 0;
+    while ( bucket < histogramBuckets.size() && milliseconds > histogramBuckets[bucket] )
+        ++bucket;
+
+    ++histogram.counts[bucket];
+    ++histogram.count;
+    histogram.sum += milliseconds;
+    histogram.max = qMax(histogram.max, milliseconds);
+}
+
+void enableMetrics()
+{
+    metricsEnabled = true;
+}
+
+bool isMetricsEnabled()
+{
+    return metricsEnabled;
+}
+
+QByteArray metricsToJson()
+{
+    enableMetrics();
+
+    auto &r = registry();
+    QMutexLocker lock(&r.mutex);
+
+    QJsonObject counters;
+    for (auto it = r.counters.constBegin(); it != r.counters.constEnd(); ++it)
+        counters.insert( QString::fromLatin1(it.key()), it.value() );
+
+    QJsonObject gauges;
+    for (auto it = r.gauges.constBegin(); it != r.gauges.constEnd(); ++it)
+        gauges.insert( QString::fromLatin1(it.key()), it.value() );
+    for (auto it = r.labeledGauges.constBegin(); it != r.labeledGauges.constEnd(); ++it) {
+        QJsonObject labels;
+        for (auto it2 = it.value().constBegin(); it2 != it.value().constEnd(); ++it2)
+            labels.insert( it2.key(), it2.value() );
+        gauges.insert( QString::fromLatin1(it.key()), labels );
+    }
+
+    QJsonObject histograms;
+    for (auto it = r.histograms.constBegin(); it != r.histograms.constEnd(); ++it)
+        histograms.insert( QString::fromLatin1(it.key()), histogramToJson(it.value()) );
+
+    const QJsonObject root{
+        {"uptimeMs", r.uptime.elapsed()},
+        {"counters", counters},
+        {"gauges", gauges},
+        {"histograms", histograms},
+    };
+    return QJsonDocument(root).toJson();
+}
+
+bool writeMetricsFile(const QString &fileName)
+{
+    QSaveFile file(fileName);
+    if ( !file.open(QIODevice::WriteOnly) )
+        return false;
+    file.write( metricsToJson() );
+    return file.commit();
+}
@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QtGlobal>
+
+class QByteArray;
+class QString;
+
+/**
+ * Process-wide registry of runtime metrics.
+ *
+ * Counters are increasing totals, gauges hold last value (optionally per
+ * label, e.g. tab name) and histograms count latencies in milliseconds.
+ */
+void addMetricCount(const char *name, qint64 value = 1);
+
+void setMetricGauge(const char *name, qint64 value);
+void setMetricGauge(const char *name, const QString &label, qint64 value);
+void removeMetricGaugeLabel(const char *name, const QString &label);
+
+void addMetricLatency(const char *name, qint64 milliseconds);
+
+/**
+ * Enables metrics which are expensive to collect (e.g. per tab).
+ *
+ * Enabled when metrics are requested or dumped to a file.
+ */
+void enableMetrics();
+bool isMetricsEnabled();
+
+/// Returns all metrics in JSON format.
+QByteArray metricsToJson();
+
+/// Writes metrics to given file atomically.
+bool writeMetricsFile(const QString &fileName);
+
+#endif // METRICS_H
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "startupprofile.h"
+
+#include "common/log.h"
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QVector>
+
+namespace {
+
+struct StartupPhase {
+    QString name;
+    qint64 elapsedNs;
+};
+
+struct StartupProfile {
+    bool enabled = false;
+    QElapsedTimer timer;
+    QVector<StartupPhase> phases;
+};
+
+StartupProfile &startupProfile()
+{
+    static StartupProfile profile;
+    return profile;
+}
+
+} // namespace
+
+void enableStartupProfile()
+{
+    auto &profile = startupProfile();
+    profile.enabled = true;
+    profile.timer.start();
+}
+
+bool isStartupProfileEnabled()
+{
+    return startupProfile().enabled;
+}
+
+void startupProfileMark(const QString &phase)
+{
+    auto &profile = startupProfile();
+    if (profile.enabled)
+        profile.phases.append({phase, profile.timer.nsecsElapsed()});
+}
+
+void printStartupProfile()
+{
+    auto &profile = startupProfile();
+    if (!profile.enabled)
+        return;
+
+    profile.enabled = false;
+
+    QString text = QStringLiteral("Startup profile (total ms, phase ms, phase):");
+    qint64 lastNs = 0;
+    for (const auto &phase : profile.phases) {
+        text.append( QStringLiteral("\n%1 %2  %3")
+                     .arg(phase.elapsedNs / 1e6, 9, 'f', 2)
+                     .arg((phase.elapsedNs - lastNs) / 1e6, 9, 'f', 2)
+                     .arg(phase.name) );
+        lastNs = phase.elapsedNs;
+    }
+
+    log(text, LogAlways);
+    profile.phases.clear();
+}
@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef STARTUPPROFILE_H
+#define STARTUPPROFILE_H
+
+class QString;
+
+/**
+ * Records time of server startup phases (enabled with --startup-profile).
+ *
+ * Profile is printed when startup finishes (first event loop iteration).
+ */
+void enableStartupProfile();
+
+bool isStartupProfileEnabled();
+
+/// Records end of a startup phase.
+void startupProfileMark(const QString &phase);
+
+/// Prints recorded phases and stops recording.
+void printStartupProfile();
+
+#endif // STARTUPPROFILE_H
@@ -0,0 +1,241 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "trace.h"
+
+#include "common/config.h"
+#include "common/log.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+namespace trace {
+
+std::atomic<bool> enabled{false};
+
+} // namespace trace
+
+namespace {
+
+const QString &traceDirPath()
+{
+    static const QString path = getConfigurationFilePath("_trace");
+    return path;
+}
+
+QString traceFilePath()
+{
+    return QStringLiteral("%1/%2.json")
+            .arg(traceDirPath())
+            .arg(QCoreApplication::applicationPid());
+}
+
+qint64 currentTimeUs()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+qint64 currentThreadId()
+{
+    return static_cast<qint64>( std::hash<std::thread::id>()(std::this_thread::get_id()) & 0xFFFFFF );
+}
+
+QByteArray toJsonLine(const QJsonObject &event)
+{
+    return QJsonDocument(event).toJson(QJsonDocument::Compact) + '\n';
+}
+
+/**
+ * Buffers spans and appends them to the trace file of the process.
+ *
+ * The file is kept open and written in batches so that spans in hot paths
+ * do not open and close the file each time. The buffer is flushed when
+ * it grows large, when a span is recorded after the flush interval and
+ * when the process exits.
+ */
+class TraceWriter final {
+public:
+    ~TraceWriter()
+    {
+        close();
+    }
+
+    void write(const QJsonObject &event)
+    {
+        QMutexLocker lock(&m_mutex);
+
+        if ( !m_file.isOpen() && !open() )
+            return;
+
+        m_buffer.append( toJsonLine(event) );
+
+        // Spans are flushed regularly so the trace can be collected from
+        // long-running processes (like clipboard monitor) at any time.
+        if ( m_buffer.size() >= maxBufferSize || m_lastFlush.elapsed() >= flushIntervalMs )
+            flushBuffer();
+    }
+
+    void close()
+    {
+        QMutexLocker lock(&m_mutex);
+        flushBuffer();
+        m_file.close();
+    }
+
+private:
+    void flushBuffer()
+    {
+        m_lastFlush.start();
+        if ( !m_file.isOpen() || m_buffer.isEmpty() )
+            return;
+
+        // Tracing was stopped (and maybe started again) from other process.
+        if ( !QFile::exists(m_file.fileName()) ) {
+            m_file.close();
+            m_buffer.clear();
+            trace::enabled = QDir(traceDirPath()).exists();
+            return;
+        }
+
+        m_file.write(m_buffer);
+        m_file.flush();
+        m_buffer.clear();
+    }
+
+    bool open()
+    {
+        m_file.setFileName( traceFilePath() );
+        if ( !m_file.open(QIODevice::Append) ) {
+            // Tracing was stopped from other process.
+            trace::enabled = false;
+            return false;
+        }
+
+        m_lastFlush.start();
+        if ( m_file.size() == 0 ) {
+            m_buffer.append( toJsonLine({
+                {"name", "process_name"},
+                {"ph", "M"},
+                {"pid", QCoreApplication::applicationPid()},
+                {"args", QJsonObject{{"name", QString::fromUtf8(logLabel())}}},
+            }) );
+        }
+        return true;
+    }
+
+    static constexpr int maxBufferSize = 64 * 1024;
+    static constexpr qint64 flushIntervalMs = 500;
+
+    QMutex m_mutex;
+    QFile m_file;
+    QByteArray m_buffer;
+    QElapsedTimer m_lastFlush;
+};
+
+TraceWriter &traceWriter()
+{
+    static TraceWriter writer;
+    return writer;
+}
+
+} // namespace
+
+void initTracing()
+{
+    trace::enabled = QDir(traceDirPath()).exists();
+}
+
+void startTracing()
+{
+    QDir().mkpath( traceDirPath() );
+    initTracing();
+}
+
+bool stopTracing(const QString &fileName, QString *error)
+{
+    trace::enabled = false;
+    traceWriter().close();
+
+    QDir dir( traceDirPath() );
+    if ( !dir.exists() ) {
+        *error = QStringLiteral("Tracing was not started");
+        return false;
+    }
+
+    QFile output(fileName);
+    if ( !output.open(QIODevice::WriteOnly) ) {
+        *error = QStringLiteral("Failed to write trace file \"%1\": %2")
+                .arg(fileName, output.errorString());
+        return false;
+    }
+
+    output.write("{\"traceEvents\":[\n");
+    bool first = true;
+    for ( const auto &traceFileName : dir.entryList({"*.json"}, QDir::Files) ) {
+        QFile input( dir.absoluteFilePath(traceFileName) );
+        if ( !input.open(QIODevice::ReadOnly) ) {
+            log( QStringLiteral("Failed to read trace file \"%1\": %2")
+                 .arg(input.fileName(), input.errorString()), LogWarning );
+            continue;
+        }
+
+        while ( !input.atEnd() ) {
+            const QByteArray line = input.readLine().trimmed();
+            if ( line.isEmpty() )
+                continue;
+            if (!first)
+                output.write(",\n");
+            output.write(line);
+            first = false;
+        }
+    }
+    output.write("\n],\"displayTimeUnit\":\"ms\"}\n");
+
+    dir.removeRecursively();
+    return true;
+}
+
+TraceSpan::TraceSpan(const char *name)
+    : m_name(name)
+{
+    if ( isTracingEnabled() )
+        m_startUs = currentTimeUs();
+}
+
+TraceSpan::TraceSpan(const char *name, const QByteArray &detail)
+    : m_name(name)
+    , m_detail(detail)
+{
+    if ( isTracingEnabled() )
+        m_startUs = currentTimeUs();
+}
+
+TraceSpan::~TraceSpan()
+{
+    if (m_startUs == -1 || !isTracingEnabled())
+        return;
+
+    QJsonObject event{
+        {"name", QString::fromUtf8(m_name)},
+        {"cat", "copyq"},
+        {"ph", "X"},
+        {"ts", m_startUs},
+        {"dur", currentTimeUs() - m_startUs},
+        {"pid", QCoreApplication::applicationPid()},
+        {"tid", currentThreadId()},
+    };
+    if ( !m_detail.isEmpty() )
+        event.insert( "args", QJsonObject{{"detail", QString::fromUtf8(m_detail)}} );
+
+    traceWriter().write(event);
+}
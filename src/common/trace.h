@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QByteArray>
+
+#include <atomic>
+
+class QString;
+
+namespace trace {
+
+extern std::atomic<bool> enabled;
+
+} // namespace trace
+
+inline bool isTracingEnabled()
+{
+    return trace::enabled.load(std::memory_order_relaxed);
+}
+
+/// Enables tracing in current process if tracing was started in the session.
+void initTracing();
+
+/// Starts tracing in the session (processes started later trace automatically).
+void startTracing();
+
+/**
+ * Stops tracing in the session and writes recorded spans from all processes
+ * to a file in Chrome trace event format (for chrome://tracing or Perfetto).
+ */
+bool stopTracing(const QString &fileName, QString *error);
+
+/**
+ * Records time spent in a scope if tracing is enabled.
+ *
+ * Use COPYQ_TRACE() and COPYQ_TRACE_DETAIL() macros instead of using this directly.
+ */
+class TraceSpan final {
+public:
+    explicit TraceSpan(const char *name);
+    TraceSpan(const char *name, const QByteArray &detail);
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    const char *m_name;
+    QByteArray m_detail;
+    qint64 m_startUs = -1;
+};
+
+#define COPYQ_TRACE_CONCAT2(a, b) a##b
+#define COPYQ_TRACE_CONCAT(a, b) COPYQ_TRACE_CONCAT2(a, b)
+
+#define COPYQ_TRACE(name) \
+    const TraceSpan COPYQ_TRACE_CONCAT(traceSpan_, __LINE__)(name)
+
+/// Same as COPYQ_TRACE() but the detail expression is evaluated only if tracing is enabled.
+#define COPYQ_TRACE_DETAIL(name, detail) \
+    const TraceSpan COPYQ_TRACE_CONCAT(traceSpan_, __LINE__) = isTracingEnabled() \
+        ? TraceSpan(name, detail) : TraceSpan(name)
+
+#endif // TRACE_H
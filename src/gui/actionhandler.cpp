@@ -9,6 +9,7 @@
 #include "common/contenttype.h"
 #include "common/display.h"
 #include "common/log.h"
+#include "common/metrics.h"
 #include "common/mimetypes.h"
 #include "common/textdata.h"
 #include "gui/actionhandlerdialog.h"
@@ -99,6 +100,8 @@ void ActionHandler::action(Action *action)
     m_actions.insert(id, action);
 
     COPYQ_LOG( QString("Executing: %1").arg(actionDescription(*action)) );
+    addMetricCount("command_launches");
+    setMetricGauge("commands_running", m_actions.size());
     action->start();
 }
 
@@ -113,6 +116,10 @@ void ActionHandler::closeAction(Action *action)
 {
     m_actions.remove(action->id());
     m_internalActions.remove(action->id());
+    setMetricGauge("commands_running", m_actions.size());
+
+    if ( action->actionFailed() || action->exitCode() != 0 )
+        addMetricCount("command_failures");
 
     if ( action->actionFailed() ) {
         const auto msg = tr("Error: %1").arg(action->errorString());
@@ -133,6 +140,8 @@ void ActionHandler::closeAction(Action *action)
     Q_ASSERT(runningActionCount() >= 0);
 
     action->deleteLater();
+
+    emit actionFinished();
 }
 
 void ActionHandler::showActionErrors(Action *action, const QString &message, ushort icon)
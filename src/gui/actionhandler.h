@@ -33,6 +33,10 @@ public:
 
     void terminateAction(int id);
 
+signals:
+    /// Emitted after a finished action is removed from running actions.
+    void actionFinished();
+
 private:
     /** Delete finished action and its menu item. */
     void closeAction(Action *action);
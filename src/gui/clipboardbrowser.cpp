@@ -5,10 +5,12 @@
 #include "common/common.h"
 #include "common/contenttype.h"
 #include "common/log.h"
+#include "common/metrics.h"
 #include "common/mimetypes.h"
 #include "common/temporaryfile.h"
 #include "common/textdata.h"
 #include "common/timer.h"
+#include "common/trace.h"
 #include "gui/clipboarddialog.h"
 #include "gui/iconfactory.h"
 #include "gui/icons.h"
@@ -101,17 +103,8 @@ private:
     QString m_filePath;
 };
 
-bool alphaSort(const QModelIndex &lhs, const QModelIndex &rhs)
-{
-    const QString lhsText = lhs.data(contentType::text).toString();
-    const QString rhsText = rhs.data(contentType::text).toString();
-    return lhsText.localeAwareCompare(rhsText) < 0;
-}
-
-bool reverseSort(const QModelIndex &lhs, const QModelIndex &rhs)
-{
-    return lhs.row() > rhs.row();
-}
+/// Sorting fewer items in background would not make UI more responsive.
+constexpr int minItemsToSortInBackground = 5000;
 
 QModelIndex indexNear(const QListView *view, int offset)
 {
@@ -234,7 +227,7 @@ ClipboardBrowser::ClipboardBrowser(
     setEditTriggers(QAbstractItemView::NoEditTriggers);
     setAlternatingRowColors(true);
 
-    initSingleShotTimer( &m_timerSave, 0, this, &ClipboardBrowser::saveItems );
+    initSingleShotTimer( &m_timerSave, 0, this, &ClipboardBrowser::saveItemsInBackground );
     initSingleShotTimer( &m_timerEmitItemCount, 0, this, &ClipboardBrowser::emitItemCount );
     initSingleShotTimer( &m_timerUpdateSizes, 0, this, &ClipboardBrowser::updateSizes );
     initSingleShotTimer( &m_timerUpdateCurrent, 0, this, &ClipboardBrowser::updateCurrent );
@@ -261,6 +254,9 @@ ClipboardBrowser::~ClipboardBrowser()
 {
     delete m_editor.data();
     saveUnsavedItems();
+
+    // Background save may still use item saver.
+    waitForBackgroundSaves();
 }
 
 bool ClipboardBrowser::moveToTop(uint itemHash)
@@ -491,6 +487,10 @@ void ClipboardBrowser::connectModelAndDelegate()
              &d, &ItemDelegate::rowsRemoved );
     connect( &m, &QAbstractItemModel::rowsAboutToBeMoved,
              &d, &ItemDelegate::rowsMoved );
+    connect( &m, &QAbstractItemModel::layoutAboutToBeChanged,
+             &d, &ItemDelegate::layoutAboutToBeChanged );
+    connect( &m, &QAbstractItemModel::layoutChanged,
+             &d, &ItemDelegate::layoutChanged );
     connect( &m, &QAbstractItemModel::dataChanged,
              &d, &ItemDelegate::dataChanged );
 
@@ -510,6 +510,8 @@ void ClipboardBrowser::connectModelAndDelegate()
              this, [this]() { delayedSaveItems(m_sharedData->saveDelayMsOnItemRemoved); } );
     connect( &m, &QAbstractItemModel::rowsMoved,
              this, [this]() { delayedSaveItems(m_sharedData->saveDelayMsOnItemMoved); } );
+    connect( &m, &QAbstractItemModel::layoutChanged,
+             this, [this]() { delayedSaveItems(m_sharedData->saveDelayMsOnItemMoved); } );
     connect( &m, &QAbstractItemModel::dataChanged,
              this, [this]() { delayedSaveItems(m_sharedData->saveDelayMsOnItemModified); } );
 
@@ -1267,6 +1269,8 @@ void ClipboardBrowser::itemModified(const QByteArray &bytes, const QString &mime
 
 void ClipboardBrowser::filterItems(const ItemFilterPtr &filter)
 {
+    COPYQ_TRACE("ClipboardBrowser::filterItems");
+
     // Search in editor if open.
     if ( isInternalEditorOpen() ) {
         m_editor->search(filter);
@@ -1523,7 +1527,7 @@ void ClipboardBrowser::remove()
 
 void ClipboardBrowser::sortItems(const QModelIndexList &indexes)
 {
-    m.sortItems(indexes, &alphaSort);
+    sortItemsBy(indexes, ItemSortKey::Text);
 }
 
 void ClipboardBrowser::sortItems(const QList<QPersistentModelIndex> &sorted)
@@ -1533,7 +1537,35 @@ void ClipboardBrowser::sortItems(const QList<QPersistentModelIndex> &sorted)
 
 void ClipboardBrowser::reverseItems(const QModelIndexList &indexes)
 {
-    m.sortItems(indexes, &reverseSort);
+    sortItemsBy(indexes, ItemSortKey::Reverse);
+}
+
+void ClipboardBrowser::sortItemsBy(const QModelIndexList &indexes, ItemSortKey key)
+{
+    QList<QPersistentModelIndex> toSort;
+    toSort.reserve( indexes.size() );
+    for (const auto &index : indexes)
+        toSort.append(index);
+
+    ItemSorter sorter(toSort, key);
+    if (sorter.size() < minItemsToSortInBackground) {
+        sorter.sort();
+        m.sortItems( sorter.sorted() );
+        return;
+    }
+
+    // Result of any previous unfinished sort is dropped.
+    auto thread = new ItemSortThread(std::move(sorter), this);
+    m_sortThread = thread;
+    connect( thread, &QThread::finished, this, [this, thread]() {
+        if (m_sortThread == thread) {
+            COPYQ_LOG( QStringLiteral("Tab \"%1\": Sorted %2 items in background")
+                       .arg(m_tabName, QString::number(thread->sorter().size())) );
+            m.sortItems( thread->sorter().sorted() );
+        }
+        thread->deleteLater();
+    } );
+    thread->start();
 }
 
 bool ClipboardBrowser::allocateSpaceForNewItems(int newItemCount)
@@ -1570,16 +1602,6 @@ bool ClipboardBrowser::add(const QString &txt, int row)
 
 bool ClipboardBrowser::add(const QVariantMap &data, int row)
 {
-    if ( !isLoaded() ) {
-        loadItems();
-        if ( !isLoaded() ) {
-            log( QString("Cannot add new items. Tab %1 is not loaded.").arg(m_tabName), LogWarning );
-            return false;
-        }
-    }
-
-    const int newRow = row < 0 ? m.rowCount() : qMin(row, m.rowCount());
-
     if ( data.contains(mimeItems) ) {
         const QByteArray bytes = data[mimeItems].toByteArray();
         QDataStream stream(bytes);
@@ -1591,20 +1613,86 @@ bool ClipboardBrowser::add(const QVariantMap &data, int row)
             dataList.append(dataMap);
         }
 
-        if ( !allocateSpaceForNewItems(dataList.size()) )
+        return addItems(dataList, row);
+    }
+
+    return addItems({data}, row);
+}
+
+bool ClipboardBrowser::addItems(const QList<QVariantMap> &dataList, int row)
+{
+    if ( !isLoaded() ) {
+        loadItems();
+        if ( !isLoaded() ) {
+            log( QString("Cannot add new items. Tab %1 is not loaded.").arg(m_tabName), LogWarning );
             return false;
+        }
+    }
+
+    const int newRow = row < 0 ? m.rowCount() : qMin(row, m.rowCount());
+
+    if ( !allocateSpaceForNewItems(dataList.size()) )
+        return false;
 
+    if ( dataList.size() == 1 )
+        m.insertItem(dataList.first(), newRow);
+    else
         m.insertItems(dataList, newRow);
-    } else {
-        if ( !allocateSpaceForNewItems(1) )
-            return false;
 
-        m.insertItem(data, newRow);
+    return true;
+}
+
+bool ClipboardBrowser::addItemsInBatch(const QList<QVariantMap> &dataList, int row)
+{
+    if ( m_batchDepth == 0 || !isLoaded() )
+        return addItems(dataList, row);
+
+    const int count = m.rowCount() + m_pendingItems.size();
+    const int newRow = row < 0 ? count : qMin(row, count);
+
+    // Only additions at the top or at the bottom of pending items are merged.
+    if ( !m_pendingItems.isEmpty()
+         && newRow != m_pendingItemsRow
+         && newRow != m_pendingItemsRow + m_pendingItems.size() )
+    {
+        flushPendingItems();
+    }
+
+    // Items need to be removed to make space.
+    if (count + dataList.size() > m_maxItemCount) {
+        flushPendingItems();
+        return addItems(dataList, newRow);
+    }
+
+    if ( m_pendingItems.isEmpty() ) {
+        m_pendingItemsRow = newRow;
+        m_pendingItems = dataList;
+    } else if (newRow == m_pendingItemsRow) {
+        for (int i = dataList.size() - 1; i >= 0; --i)
+            m_pendingItems.prepend(dataList[i]);
+    } else {
+        m_pendingItems.append(dataList);
     }
 
     return true;
 }
 
+void ClipboardBrowser::flushPendingItems()
+{
+    if ( m_pendingItems.isEmpty() )
+        return;
+
+    QList<QVariantMap> dataList;
+    dataList.swap(m_pendingItems);
+    // Items could have been removed in the meantime (e.g. from GUI).
+    addItems( dataList, qMin(m_pendingItemsRow, m.rowCount()) );
+}
+
+qint64 ClipboardBrowser::estimatedMemoryBytes() const
+{
+    return d.estimatedWidgetBytes() + m.dataBytes();
+}
+
 bool ClipboardBrowser::addAndSelect(const QVariantMap &data, int row)
 {
     m_selectNewItems = true;
@@ -1616,10 +1704,13 @@ bool ClipboardBrowser::addAndSelect(const QVariantMap &data, int row)
 void ClipboardBrowser::addUnique(const QVariantMap &data, ClipboardMode mode)
 {
     if ( moveToTop(hash(data)) ) {
+        addMetricCount("clipboard_duplicates");
         COPYQ_LOG("New item: Moving existing to top");
         return;
     }
 
+    addMetricCount("clipboard_items_stored");
+
     // When selecting text under X11, clipboard data may change whenever selection changes.
     // Instead of adding item for each selection change, this updates previously added item.
     // Also update previous item if the same selected text is copied to clipboard afterwards.
@@ -1638,6 +1729,7 @@ void ClipboardBrowser::addUnique(const QVariantMap &data, ClipboardMode mode)
                  ? (newText == oldText)
                  : newText.contains(oldText) )
             {
+                addMetricCount("clipboard_merged");
                 COPYQ_LOG("New item: Merging with top item");
 
                 auto newData = previousData;
@@ -1691,16 +1783,49 @@ bool ClipboardBrowser::saveItems()
     return ::saveItems(m_tabName, m, m_itemSaver);
 }
 
+void ClipboardBrowser::saveItemsInBackground()
+{
+    m_timerSave.stop();
+
+    if ( !isLoaded() || m_tabName.isEmpty() || !m_storeItems )
+        return;
+
+    ::saveItemsInBackground(m_tabName, m, m_itemSaver);
+}
+
 void ClipboardBrowser::moveToClipboard()
 {
     moveToClipboard( selectionModel()->selectedIndexes() );
 }
 
+void ClipboardBrowser::beginBatch()
+{
+    ++m_batchDepth;
+}
+
+void ClipboardBrowser::endBatch()
+{
+    if (m_batchDepth == 0 || --m_batchDepth > 0)
+        return;
+
+    flushPendingItems();
+
+    const int saveDelayMs = m_batchSaveDelayMs;
+    m_batchSaveDelayMs = -1;
+    delayedSaveItems(saveDelayMs);
+}
+
 void ClipboardBrowser::delayedSaveItems(int ms)
 {
     if ( !isLoaded() || tabName().isEmpty() || ms < 0 )
         return;
 
+    if (m_batchDepth > 0) {
+        if (m_batchSaveDelayMs < 0 || ms < m_batchSaveDelayMs)
+            m_batchSaveDelayMs = ms;
+        return;
+    }
+
     if ( !m_timerSave.isActive() || ms < m_timerSave.remainingTime() )
         m_timerSave.start(ms);
 
@@ -1736,7 +1861,10 @@ void ClipboardBrowser::updateCurrent()
 
 void ClipboardBrowser::saveUnsavedItems()
 {
-    if ( m_timerSave.isActive() )
+    flushPendingItems();
+
+    // Saving can be still postponed until the end of a batch.
+    if ( m_timerSave.isActive() || m_batchSaveDelayMs >= 0 )
         saveItems();
 }
 
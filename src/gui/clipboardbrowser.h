@@ -9,6 +9,7 @@
 #include "item/clipboardmodel.h"
 #include "item/itemdelegate.h"
 #include "item/itemfilter.h"
+#include "item/itemsort.h"
 #include "item/itemwidget.h"
 
 #include <QListView>
@@ -47,7 +48,11 @@ class ClipboardBrowser final : public QListView
          */
         bool moveToTop(uint itemHash);
 
-        /** Sort selected items. */
+        /**
+         * Sort selected items.
+         *
+         * Many items are sorted in background and moved only after the sort finishes.
+         */
         void sortItems(const QModelIndexList &indexes);
         void sortItems(const QList<QPersistentModelIndex> &sorted);
 
@@ -125,6 +130,27 @@ class ClipboardBrowser final : public QListView
                 int row = 0 //!< Target row for the new item (negative to append item).
                 );
 
+        /**
+         * Add new items to the browser at once.
+         * First item in the list is placed at the target row.
+         */
+        bool addItems(
+                const QList<QVariantMap> &dataList, //!< Data for new items.
+                int row = 0 //!< Target row for the new items (negative to append items).
+                );
+
+        /**
+         * Add new items at once, or later if in a batch.
+         *
+         * In a batch, consecutive additions at the same position are kept
+         * and inserted to the model at once with flushPendingItems() (or at
+         * the end of the batch).
+         */
+        bool addItemsInBatch(const QList<QVariantMap> &dataList, int row);
+
+        /** Inserts items kept by addItemsInBatch(). */
+        void flushPendingItems();
+
         bool addAndSelect(const QVariantMap &data, int row);
 
         /**
@@ -135,6 +161,9 @@ class ClipboardBrowser final : public QListView
         /** Number of items in list. */
         int length() const { return m.rowCount(); }
 
+        /** Returns approximate memory used by item data and item widgets. */
+        qint64 estimatedMemoryBytes() const;
+
         /** Receive key event. */
         void keyEvent(QKeyEvent *event) { keyPressEvent(event); }
         /** Move item to clipboard. */
@@ -156,6 +185,14 @@ class ClipboardBrowser final : public QListView
          */
         void saveUnsavedItems();
 
+        /**
+         * Defer saving items and change notifications until matching endBatch().
+         *
+         * Calls can be nested.
+         */
+        void beginBatch();
+        void endBatch();
+
         /**
          * Create and edit new item.
          */
@@ -293,6 +330,8 @@ class ClipboardBrowser final : public QListView
         void closeExternalEditor(QObject *editor, const QModelIndex &index);
 
     private:
+        void sortItemsBy(const QModelIndexList &indexes, ItemSortKey key);
+
         void onRowsInserted(const QModelIndex &parent, int first, int last);
 
         void onItemCountChanged();
@@ -310,6 +349,11 @@ class ClipboardBrowser final : public QListView
          */
         void delayedSaveItems(int ms);
 
+        /**
+         * Save items to configuration in background.
+         */
+        void saveItemsInBackground();
+
         /**
          * Update item and editor sizes.
          */
@@ -403,6 +447,13 @@ class ClipboardBrowser final : public QListView
         int m_filterRow = -1;
 
         bool m_selectNewItems = false;
+
+        int m_batchDepth = 0;
+        int m_batchSaveDelayMs = -1;
+        QList<QVariantMap> m_pendingItems;
+        int m_pendingItemsRow = 0;
+
+        QPointer<ItemSortThread> m_sortThread;
 };
 
 #endif // CLIPBOARDBROWSER_H
@@ -10,6 +10,7 @@
 #include "gui/iconfactory.h"
 #include "gui/icons.h"
 
+#include <QDateTime>
 #include <QPushButton>
 #include <QVBoxLayout>
 #include <QWidget>
@@ -131,6 +132,7 @@ void ClipboardBrowserPlaceholder::reloadBrowser()
 
 void ClipboardBrowserPlaceholder::showEvent(QShowEvent *event)
 {
+    m_lastAccessMs = QDateTime::currentMSecsSinceEpoch();
     QWidget::showEvent(event);
     QTimer::singleShot(0, this, [this](){
         if ( isVisible() )
@@ -159,6 +161,11 @@ bool ClipboardBrowserPlaceholder::expire()
     return false;
 }
 
+qint64 ClipboardBrowserPlaceholder::estimatedMemoryBytes() const
+{
+    return m_browser ? m_browser->estimatedMemoryBytes() : 0;
+}
+
 void ClipboardBrowserPlaceholder::setActiveWidget(QWidget *widget)
 {
     layout()->addWidget(widget);
@@ -216,6 +223,8 @@ bool ClipboardBrowserPlaceholder::canExpire() const
 
 void ClipboardBrowserPlaceholder::restartExpiring()
 {
+    m_lastAccessMs = QDateTime::currentMSecsSinceEpoch();
+
     const int expireTimeoutMs = 60000 * m_sharedData->minutesToExpire;
     if (expireTimeoutMs > 0)
         m_timerExpire.start(expireTimeoutMs);
@@ -53,6 +53,12 @@ public:
 
     void unloadBrowser();
 
+    /// Returns approximate memory used by the loaded browser (0 if not loaded).
+    qint64 estimatedMemoryBytes() const;
+
+    /// Returns time of the last use of the browser (milliseconds since epoch).
+    qint64 lastAccessMs() const { return m_lastAccessMs; }
+
     void createLoadButton();
 
 signals:
@@ -81,6 +87,7 @@ private:
     ClipboardBrowserSharedPtr m_sharedData;
 
     QTimer m_timerExpire;
+    qint64 m_lastAccessMs = 0;
 };
 
 #endif // CLIPBOARDBROWSERPLACEHOLDER_H
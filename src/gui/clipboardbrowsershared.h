@@ -23,6 +23,7 @@ struct ClipboardBrowserShared {
     bool showSimpleItems = false;
     bool numberSearch = false;
     int minutesToExpire = 0;
+    qint64 tabMemoryLimitBytes = 0;
     int saveDelayMsOnItemAdded = 0;
     int saveDelayMsOnItemModified = 0;
     int saveDelayMsOnItemRemoved = 0;
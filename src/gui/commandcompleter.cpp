@@ -13,13 +13,19 @@
 #include <QHash>
 #include <QHeaderView>
 #include <QKeyEvent>
+#include <QPointer>
+#include <QRegularExpression>
 #include <QTableView>
+#include <QTextBlock>
+#include <QTextDocument>
 #include <QTimer>
 #include <QPlainTextEdit>
 #include <QScrollBar>
 #include <QStringListModel>
 #include <QShortcut>
 
+#include <algorithm>
+
 namespace {
 
 const QLatin1String tagObject("obj");
@@ -28,32 +34,80 @@ const QLatin1String tagProperty("prop");
 const QLatin1String tagFunction("fn");
 const QLatin1String tagKeyword("kw");
 
-class CommandCompleterModel final : public QStringListModel {
-public:
-    explicit CommandCompleterModel(QObject *parent)
-        : QStringListModel(parent)
-    {
-        for (const QString &name : scriptableObjects()) {
-            if (name.size() > 1 && name[0].isUpper() && name[1].isLower())
-                m_doc[name].tag = tagType;
-            else
-                m_doc[name].tag = tagObject;
-        }
+const QLatin1String tagIdentifier("id");
+
+struct ScriptableDocumentation {
+    QString tag;
+    QString doc;
+};
+
+QHash<QString, ScriptableDocumentation> createDocumentation()
+{
+    QHash<QString, ScriptableDocumentation> documentation;
+
+    for (const QString &name : scriptableObjects()) {
+        if (name.size() > 1 && name[0].isUpper() && name[1].isLower())
+            documentation[name].tag = tagType;
+        else
+            documentation[name].tag = tagObject;
+    }
+
+    for (const auto &name : scriptableProperties())
+        documentation[name].tag = tagProperty;
+
+    for (const auto &name : scriptableFunctions())
+        documentation[name].tag = tagFunction;
+
+    for (const auto &name : scriptableKeywords())
+        documentation[name].tag = tagKeyword;
+
+    addDocumentation(
+        [&documentation](const QString &name, const QString &api, const QString &text) {
+            auto &doc = documentation[name].doc;
+            if (!doc.isEmpty())
+                doc.append("\n");
+            doc.append(api + "\n    " + text);
+        });
+
+    return documentation;
+}
 
-        for (const auto &name : scriptableProperties())
-            m_doc[name].tag = tagProperty;
+const QHash<QString, ScriptableDocumentation> &documentation()
+{
+    static const auto documentation = createDocumentation();
+    return documentation;
+}
 
-        for (const auto &name : scriptableFunctions())
-            m_doc[name].tag = tagFunction;
+/// Order expected by QCompleter::CaseInsensitivelySortedModel.
+bool lessCaseInsensitive(const QString &lhs, const QString &rhs)
+{
+    return QString::compare(lhs, rhs, Qt::CaseInsensitive) < 0;
+}
 
-        for (const auto &name : scriptableKeywords())
-            m_doc[name].tag = tagKeyword;
+QStringList createDocumentedNames()
+{
+    QStringList names = documentation().keys();
+    std::sort(std::begin(names), std::end(names), lessCaseInsensitive);
+    return names;
+}
 
-        addDocumentation();
+const QStringList &documentedNames()
+{
+    static const QStringList names = createDocumentedNames();
+    return names;
+}
 
-        QStringList completionItems = m_doc.keys();
-        std::sort(std::begin(completionItems), std::end(completionItems));
-        setStringList(completionItems);
+/**
+ * Completion items: documented names and identifiers from the script.
+ *
+ * Items are kept sorted so QCompleter can find a prefix with binary search
+ * and identifiers can be added and removed without resetting the model.
+ */
+class CommandCompleterModel final : public QStringListModel {
+public:
+    explicit CommandCompleterModel(QObject *parent)
+        : QStringListModel(documentedNames(), parent)
+    {
     }
 
     int columnCount(const QModelIndex &) const override
@@ -88,28 +142,60 @@ public:
         return QStringListModel::data(index, role);
     }
 
-private:
-    struct ScriptableDocumentation {
-        QString tag;
-        QString doc;
-    };
+    /// Adds an occurrence of identifier in script.
+    void addIdentifier(const QString &name)
+    {
+        if ( documentation().contains(name) )
+            return;
+
+        int &count = m_identifierCounts[name];
+        ++count;
+        if (count > 1)
+            return;
+
+        const int row = lowerBoundRow(name);
+        insertRows(row, 1);
+        setData(index(row), name);
+    }
+
+    /// Removes an occurrence of identifier in script.
+    void removeIdentifier(const QString &name)
+    {
+        const auto it = m_identifierCounts.find(name);
+        if ( it == m_identifierCounts.end() )
+            return;
+
+        --it.value();
+        if (it.value() > 0)
+            return;
+
+        m_identifierCounts.erase(it);
+
+        const QStringList names = stringList();
+        for (int row = lowerBoundRow(name); row < names.size(); ++row) {
+            if (names[row] == name) {
+                removeRows(row, 1);
+                break;
+            }
+            if ( lessCaseInsensitive(name, names[row]) )
+                break;
+        }
+    }
 
-    void addDocumentation()
+private:
+    int lowerBoundRow(const QString &name) const
     {
-        ::addDocumentation(
-            [this](const QString &name, const QString &api, const QString &documentation) {
-                auto &doc = m_doc[name].doc;
-                if (!doc.isEmpty())
-                    doc.append("\n");
-                doc.append(api + "\n    " + documentation);
-            });
+        const QStringList names = stringList();
+        const auto it = std::lower_bound(
+            std::begin(names), std::end(names), name, lessCaseInsensitive);
+        return static_cast<int>( std::distance(std::begin(names), it) );
     }
 
     ScriptableDocumentation documentationForRow(int row) const
     {
         const auto index2 = this->index(row, 0);
         const auto text = QStringListModel::data(index2, Qt::EditRole).toString();
-        return m_doc.value(text);
+        return documentation().value(text, ScriptableDocumentation{tagIdentifier, QString()});
     }
 
     QString typeForRow(int row) const
@@ -125,12 +211,65 @@ private:
             return QStringLiteral("function");
         if (tagText == tagKeyword)
             return QStringLiteral("keyword");
+        if (tagText == tagIdentifier)
+            return QStringLiteral("identifier in script");
         return tagText;
     }
 
-    QHash<QString, ScriptableDocumentation> m_doc;
+    QHash<QString, int> m_identifierCounts;
+};
+
+/**
+ * Identifiers in a text block.
+ *
+ * The identifiers are removed from completion when the block changes or is
+ * removed from the document.
+ */
+class BlockIdentifiers final : public QTextBlockUserData {
+public:
+    BlockIdentifiers(CommandCompleterModel *model, const QStringList &identifiers)
+        : m_model(model)
+        , m_identifiers(identifiers)
+    {
+        for (const auto &identifier : m_identifiers)
+            m_model->addIdentifier(identifier);
+    }
+
+    ~BlockIdentifiers()
+    {
+        if (!m_model)
+            return;
+
+        for (const auto &identifier : m_identifiers)
+            m_model->removeIdentifier(identifier);
+    }
+
+private:
+    QPointer<CommandCompleterModel> m_model;
+    QStringList m_identifiers;
 };
 
+QStringList scriptIdentifiers(const QTextBlock &block, int cursorPosition)
+{
+    static const QRegularExpression reIdentifier("(?<![\\w$])[A-Za-z_$][\\w$]{2,}");
+
+    QStringList identifiers;
+    auto it = reIdentifier.globalMatch( block.text() );
+    while (it.hasNext()) {
+        const auto m = it.next();
+
+        // Omit word which is being typed.
+        const int start = block.position() + m.capturedStart();
+        if (start <= cursorPosition && cursorPosition <= start + m.capturedLength())
+            continue;
+
+        identifiers.append( m.captured() );
+    }
+
+    identifiers.removeDuplicates();
+    return identifiers;
+}
+
 void setUpHeader(QHeaderView *header)
 {
     header->hide();
@@ -206,6 +345,7 @@ CommandCompleter::CommandCompleter(QPlainTextEdit *editor)
     m_completer->setWidget(m_editor);
     m_completer->setCompletionMode(QCompleter::PopupCompletion);
     m_completer->setCaseSensitivity(Qt::CaseInsensitive);
+    m_completer->setModelSorting(QCompleter::CaseInsensitivelySortedModel);
 
     m_completer->setPopup(new CommandCompleterPopup(m_editor));
     m_completer->popup()->installEventFilter(this);
@@ -215,12 +355,16 @@ CommandCompleter::CommandCompleter(QPlainTextEdit *editor)
 
     connect( m_editor, &QPlainTextEdit::textChanged,
              this, &CommandCompleter::onTextChanged );
+    connect( m_editor->document(), &QTextDocument::contentsChange,
+             this, &CommandCompleter::onContentsChange );
     connect( m_editor, &QPlainTextEdit::cursorPositionChanged,
              m_completer->popup(), &QWidget::hide );
 
     auto shortcut = new QShortcut(tr("Ctrl+Space", "Shortcut to show completion menu"), editor);
     connect( shortcut, &QShortcut::activated,
              this, &CommandCompleter::showCompletion );
+
+    onContentsChange(0, 0, m_editor->document()->characterCount());
 }
 
 bool CommandCompleter::eventFilter(QObject *, QEvent *event)
@@ -260,6 +404,21 @@ void CommandCompleter::onTextChanged()
     updateCompletion(false);
 }
 
+void CommandCompleter::onContentsChange(int position, int, int charsAdded)
+{
+    auto model = static_cast<CommandCompleterModel*>(m_completer->model());
+    const int cursorPosition = m_editor->textCursor().position();
+    QTextDocument *document = m_editor->document();
+    const QTextBlock lastBlock = document->findBlock(position + charsAdded);
+
+    // Only blocks with changes are scanned for identifiers.
+    for (auto block = document->findBlock(position); block.isValid(); block = block.next()) {
+        block.setUserData( new BlockIdentifiers(model, scriptIdentifiers(block, cursorPosition)) );
+        if (block == lastBlock)
+            break;
+    }
+}
+
 void CommandCompleter::updateCompletion(bool forceShow)
 {
     const QString completionPrefix = textUnderCursor();
@@ -21,6 +21,7 @@ public:
 
 private:
     void onTextChanged();
+    void onContentsChange(int position, int charsRemoved, int charsAdded);
     void updateCompletion(bool forceShow);
     void insertCompletion(const QString &completion);
     void showCompletion();
@@ -51,6 +51,8 @@ void addDocumentation(AddDocumentationCallback addDocumentation)
     addDocumentation("add", "add(text|Item...)", "Same as `insert(0, ...)`.");
     addDocumentation("insert", "insert(row, text|Item...)", "Inserts new items to current tab.");
     addDocumentation("remove", "remove(row, ...)", "Removes items in current tab.");
+    addDocumentation("beginBatch", "beginBatch()", "Defers saving current tab and change notifications until endBatch().");
+    addDocumentation("endBatch", "endBatch()", "Ends batch started with beginBatch().");
     addDocumentation("move", "move(row)", "Moves selected items to given row in same tab.");
     addDocumentation("edit", "edit([row|text] ...)", "Edits items in current tab.");
     addDocumentation("read", "read([mimeType])", "Same as `clipboard()`.");
@@ -92,6 +94,9 @@ void addDocumentation(AddDocumentationCallback addDocumentation)
     addDocumentation("dataFormats", "dataFormats() -> array of strings", "Returns formats available for `data()`.");
     addDocumentation("print", "print(value)", "Prints value to standard output.");
     addDocumentation("serverLog", "serverLog(value)", "Prints value to application log.");
+    addDocumentation("metrics", "metrics() -> string", "Returns runtime metrics of the server (counters, gauges and latency histograms) in JSON format.");
+    addDocumentation("traceStart", "traceStart()", "Starts recording trace spans in server and all client processes.");
+    addDocumentation("traceStop", "traceStop(fileName)", "Stops recording trace spans and saves them to a file in Chrome trace event format.");
     addDocumentation("logs", "logs() -> string", "Returns application logs.");
     addDocumentation("abort", "abort()", "Aborts script evaluation.");
     addDocumentation("fail", "fail()", "Aborts script evaluation with nonzero exit code.");
@@ -5,6 +5,7 @@
 #include "gui/iconfactory.h"
 #include "scriptable/scriptable.h"
 
+#include <QHash>
 #include <QMetaMethod>
 #include <QMetaObject>
 #include <QPalette>
@@ -43,13 +44,6 @@ QRegularExpression commandLabelRegExp()
                 );
 }
 
-QRegularExpression createRegExp(const QStringList &list)
-{
-    QRegularExpression re;
-    re.setPattern("\\b" + list.join("\\b|\\b") + "\\b");
-    return re;
-}
-
 int mixColorComponent(int a, int b)
 {
     return qMin(255, qMax(0, a + b));
@@ -65,16 +59,53 @@ QColor mixColor(const QColor &color, int r, int g, int b)
                 );
 }
 
+/// Type of known name; if a name has multiple types, the last one is used.
+enum class NameType {
+    Object,
+    Property,
+    Function,
+    Keyword,
+};
+
+QHash<QString, NameType> createNameTypes()
+{
+    QHash<QString, NameType> nameTypes;
+    for (const auto &name : scriptableObjects())
+        nameTypes[name] = NameType::Object;
+    for (const auto &name : scriptableProperties())
+        nameTypes[name] = NameType::Property;
+    for (const auto &name : scriptableFunctions())
+        nameTypes[name] = NameType::Function;
+    for (const auto &name : scriptableKeywords())
+        nameTypes[name] = NameType::Keyword;
+    return nameTypes;
+}
+
+const QHash<QString, NameType> &nameTypes()
+{
+    static const QHash<QString, NameType> nameTypes = createNameTypes();
+    return nameTypes;
+}
+
+bool isWordCharacter(QChar c)
+{
+    return c.isLetterOrNumber() || c == '_';
+}
+
+/**
+ * Highlights script code.
+ *
+ * QSyntaxHighlighter re-highlights only changed blocks and following blocks
+ * while the state at the block end (string, comment etc.) changes, so each
+ * block is tokenized only once; names are looked up in a hash table instead
+ * of matching them with large regular expressions.
+ */
 class CommandSyntaxHighlighter final : public QSyntaxHighlighter
 {
 public:
     explicit CommandSyntaxHighlighter(QWidget *editor, QTextDocument *parent)
         : QSyntaxHighlighter(parent)
         , m_editor(editor)
-        , m_reObjects(createRegExp(scriptableObjects()))
-        , m_reProperties(createRegExp(scriptableProperties()))
-        , m_reFunctions(createRegExp(scriptableFunctions()))
-        , m_reKeywords(createRegExp(scriptableKeywords()))
         , m_reLabels(commandLabelRegExp())
         , m_reConstants("\\b0x[0-9A-Fa-f]+|(?:\\b|%)\\d+|\\btrue\\b|\\bfalse\\b")
     {
@@ -83,48 +114,87 @@ public:
 protected:
     void highlightBlock(const QString &text) override
     {
-        m_bgColor = getDefaultIconColor(*m_editor);
+        updateFormats();
+        highlightNames(text);
+        highlight(text, m_reLabels, m_labelsFormat);
+        highlight(text, m_reConstants, m_constantFormat);
+        highlightBlocks(text);
+    }
+
+private:
+    enum State {
+        Code,
+        SingleQuote,
+        DoubleQuote,
+        BackTick,
+        RegExp,
+        Comment
+    };
+
+    void updateFormats()
+    {
+        const QColor bgColor = getDefaultIconColor(*m_editor);
+        if (bgColor == m_bgColor)
+            return;
+
+        m_bgColor = bgColor;
 
         QTextCharFormat objectsFormat;
         objectsFormat.setForeground(mixColor(m_bgColor, 40, -60, 40));
         objectsFormat.setToolTip("Object");
-        highlight(text, m_reObjects, objectsFormat);
+        m_nameFormats[static_cast<int>(NameType::Object)] = objectsFormat;
 
         QTextCharFormat propertyFormat;
         propertyFormat.setForeground(mixColor(m_bgColor, -60, 40, 40));
-        highlight(text, m_reProperties, propertyFormat);
+        m_nameFormats[static_cast<int>(NameType::Property)] = propertyFormat;
 
         QTextCharFormat functionFormat;
         functionFormat.setForeground(mixColor(m_bgColor, -40, -40, 40));
-        highlight(text, m_reFunctions, functionFormat);
+        m_nameFormats[static_cast<int>(NameType::Function)] = functionFormat;
 
         QTextCharFormat keywordFormat;
         keywordFormat.setFontWeight(QFont::Bold);
-        highlight(text, m_reKeywords, keywordFormat);
+        m_nameFormats[static_cast<int>(NameType::Keyword)] = keywordFormat;
 
-        QTextCharFormat labelsFormat;
-        labelsFormat.setFontWeight(QFont::Bold);
-        labelsFormat.setForeground(mixColor(m_bgColor, 40, 40, -40));
-        highlight(text, m_reLabels, labelsFormat);
+        m_labelsFormat = QTextCharFormat();
+        m_labelsFormat.setFontWeight(QFont::Bold);
+        m_labelsFormat.setForeground(mixColor(m_bgColor, 40, 40, -40));
 
-        QTextCharFormat constantFormat;
-        constantFormat.setForeground(mixColor(m_bgColor, 40, -40, -40));
-        highlight(text, m_reConstants, constantFormat);
+        m_constantFormat = QTextCharFormat();
+        m_constantFormat.setForeground(mixColor(m_bgColor, 40, -40, -40));
 
-        highlightBlocks(text);
+        m_stringFormat = QTextCharFormat();
+        m_stringFormat.setForeground(mixColor(m_bgColor, -40, 40, -40));
+
+        const int x = m_bgColor.lightness() > 100 ? -40 : 40;
+        m_commentFormat = QTextCharFormat();
+        m_commentFormat.setForeground( mixColor(m_bgColor, x, x, x) );
+
+        m_regExpFormat = QTextCharFormat();
+        m_regExpFormat.setForeground(mixColor(m_bgColor, 40, -40, -40));
     }
 
-private:
-    enum State {
-        Code,
-        SingleQuote,
-        DoubleQuote,
-        BackTick,
-        RegExp,
-        Comment
-    };
+    void highlightNames(const QString &text)
+    {
+        const auto &types = nameTypes();
+        int i = 0;
+        while (i < text.size()) {
+            if ( !isWordCharacter(text[i]) ) {
+                ++i;
+                continue;
+            }
+
+            const int start = i;
+            while ( i < text.size() && isWordCharacter(text[i]) )
+                ++i;
 
-    void highlight(const QString &text, QRegularExpression &re, const QTextCharFormat &format)
+            const auto it = types.constFind( text.mid(start, i - start) );
+            if ( it != types.constEnd() )
+                setFormat( start, i - start, m_nameFormats[static_cast<int>(it.value())] );
+        }
+    }
+
+    void highlight(const QString &text, const QRegularExpression &re, const QTextCharFormat &format)
     {
         auto it = re.globalMatch(text);
         while (it.hasNext()) {
@@ -135,20 +205,13 @@ private:
 
     void format(int a, int b)
     {
-        QTextCharFormat format;
         const int state = currentBlockState();
-        if (state == SingleQuote || state == DoubleQuote || state == BackTick) {
-            format.setForeground(mixColor(m_bgColor, -40, 40, -40));
-        } else if (state == Comment) {
-            const int x = m_bgColor.lightness() > 100 ? -40 : 40;
-            format.setForeground( mixColor(m_bgColor, x, x, x) );
-        } else if (state == RegExp) {
-            format.setForeground(mixColor(m_bgColor, 40, -40, -40));
-        } else {
-            return;
-        }
-
-        setFormat(a, b - a + 1, format);
+        if (state == SingleQuote || state == DoubleQuote || state == BackTick)
+            setFormat(a, b - a + 1, m_stringFormat);
+        else if (state == Comment)
+            setFormat(a, b - a + 1, m_commentFormat);
+        else if (state == RegExp)
+            setFormat(a, b - a + 1, m_regExpFormat);
     }
 
     bool peek(const QString &text, int i, const QString &what)
@@ -194,7 +257,8 @@ private:
             } else if (currentBlockState() == RegExp) {
                 if (c == '/') {
                     // Highlight paths outside code as regexps.
-                    i = text.indexOf(QRegularExpression("[^a-zA-Z0-9./_-]"), i);
+                    static const QRegularExpression reNotPath("[^a-zA-Z0-9./_-]");
+                    i = text.indexOf(reNotPath, i);
                     if (i == -1)
                         i = text.size();
 
@@ -232,13 +296,15 @@ private:
     }
 
     QWidget *m_editor;
-    QRegularExpression m_reObjects;
-    QRegularExpression m_reProperties;
-    QRegularExpression m_reFunctions;
-    QRegularExpression m_reKeywords;
     QRegularExpression m_reLabels;
     QRegularExpression m_reConstants;
     QColor m_bgColor;
+    QTextCharFormat m_nameFormats[4];
+    QTextCharFormat m_labelsFormat;
+    QTextCharFormat m_constantFormat;
+    QTextCharFormat m_stringFormat;
+    QTextCharFormat m_commentFormat;
+    QTextCharFormat m_regExpFormat;
 };
 
 bool isPublicName(const QString &name)
@@ -8,11 +8,13 @@
 #include "gui/pixelratio.h"
 
 #include <QBitmap>
+#include <QCache>
 #include <QCoreApplication>
 #include <QFile>
 #include <QFont>
 #include <QFontDatabase>
 #include <QFontMetrics>
+#include <QHash>
 #include <QIcon>
 #include <QIconEngine>
 #include <QPainter>
@@ -22,6 +24,7 @@
 #include <QPixmap>
 #include <QPixmapCache>
 #include <QPointer>
+#include <QStyle>
 #include <QSvgRenderer>
 #include <QVariant>
 #include <QWidget>
@@ -37,6 +40,71 @@ const int lightThreshold = 100;
 
 bool sessionIconTagEnabledFlag = true;
 
+/**
+ * Key for a rendered icon in icon atlas.
+ *
+ * First number contains icon ID, width, height and tag ID, second contains
+ * icon color and tag color.
+ */
+using IconAtlasKey = QPair<quint64, quint64>;
+
+/// Tag ID reserved for app icons.
+constexpr int appIconTagId = 0xFFFF;
+
+/// Maximum size of all rendered icons in KiB.
+constexpr int iconAtlasMaxCostKiB = 8 * 1024;
+
+/**
+ * Rendered icons, separate from QPixmapCache so that large pixmaps from
+ * other places do not evict them.
+ */
+QCache<IconAtlasKey, QPixmap> &iconAtlas()
+{
+    static QCache<IconAtlasKey, QPixmap> atlas(iconAtlasMaxCostKiB);
+    return atlas;
+}
+
+/// Returns small number for tag text, 0 for no tag or -1 if there are too many tags.
+int tagId(const QString &tag)
+{
+    if ( tag.isEmpty() )
+        return 0;
+
+    static QHash<QString, int> tagIds;
+    const auto it = tagIds.constFind(tag);
+    if ( it != tagIds.constEnd() )
+        return it.value();
+
+    const int id = tagIds.size() + 1;
+    if (id >= appIconTagId)
+        return -1;
+
+    tagIds.insert(tag, id);
+    return id;
+}
+
+IconAtlasKey iconAtlasKey(ushort id, int w, int h, int tagId, QRgb color, QRgb tagColor)
+{
+    return IconAtlasKey(
+        (static_cast<quint64>(id) << 48)
+        | (static_cast<quint64>(w & 0xFFFF) << 32)
+        | (static_cast<quint64>(h & 0xFFFF) << 16)
+        | static_cast<quint64>(tagId & 0xFFFF),
+        (static_cast<quint64>(color) << 32) | tagColor );
+}
+
+QPixmap findIconInAtlas(const IconAtlasKey &key)
+{
+    const QPixmap *pixmap = iconAtlas().object(key);
+    return pixmap ? *pixmap : QPixmap();
+}
+
+void addIconToAtlas(const IconAtlasKey &key, const QPixmap &pixmap)
+{
+    const int cost = pixmap.width() * pixmap.height() * pixmap.depth() / 8 / 1024 + 1;
+    iconAtlas().insert( key, new QPixmap(pixmap), cost );
+}
+
 QPointer<QObject> &activePaintDevice() {
     static QPointer<QObject> activePaintDevice;
     return activePaintDevice;
@@ -237,55 +305,6 @@ void disableIcon(QPixmap *pix)
     *pix = pix2;
 }
 
-QPixmap drawFontIcon(ushort id, int w, int h, const QColor &color)
-{
-    const auto cacheKey = QStringLiteral("id:%1|%2x%3|%4")
-            .arg(id)
-            .arg(w)
-            .arg(h)
-            .arg(color.rgba());
-
-    {
-        QPixmap pixmap;
-        if ( QPixmapCache::find(cacheKey, &pixmap) )
-            return pixmap;
-    }
-
-    QPixmap pixmap(w, h);
-    pixmap.fill(Qt::transparent);
-
-    id = fixIconId(id);
-
-    QPainter painter(&pixmap);
-    painter.setRenderHint(QPainter::TextAntialiasing);
-    painter.setRenderHint(QPainter::Antialiasing);
-    const QFont font = iconFontFitSize(w, h);
-
-    painter.setFont(font);
-
-    // Center the icon to whole pixels so it stays sharp.
-    const auto flags = Qt::AlignTop | Qt::AlignLeft;
-    const auto iconText = QString(QChar(id));
-    auto boundingRect = painter.boundingRect(0, 0, w, h, flags, iconText);
-    const auto x = w - boundingRect.width();
-    // If icon is wider, assume that a tag will be rendered and align image to the right.
-    const auto pos = boundingRect.bottomLeft()
-            + ((w > h) ? QPoint(x * 3 / 4, 0) : QPoint(x / 2, 0));
-
-    // Draw shadow.
-    painter.setPen(Qt::black);
-    painter.setOpacity(0.2);
-    painter.drawText(pos + QPoint(1, 1), iconText);
-    painter.setOpacity(1);
-
-    painter.setPen(color);
-    painter.drawText(pos, iconText);
-
-    QPixmapCache::insert(cacheKey, pixmap);
-
-    return pixmap;
-}
-
 QColor getDefaultIconColor(const QColor &color)
 {
     QColor c = color;
@@ -335,6 +354,57 @@ void tagIcon(QPixmap *pix, const QString &tag, QColor color)
     painter.drawText(pos, tag);
 }
 
+QPixmap drawFontIcon(
+        ushort id, int w, int h, const QColor &color,
+        const QString &tag = QString(), const QColor &tagColor = QColor())
+{
+    const int iconTagId = tagId(tag);
+    const auto key = iconAtlasKey(id, w, h, iconTagId, color.rgba(), tagColor.rgba());
+    if (iconTagId != -1) {
+        const QPixmap pixmap = findIconInAtlas(key);
+        if ( !pixmap.isNull() )
+            return pixmap;
+    }
+
+    QPixmap pixmap(w, h);
+    pixmap.fill(Qt::transparent);
+
+    id = fixIconId(id);
+
+    QPainter painter(&pixmap);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    painter.setRenderHint(QPainter::Antialiasing);
+    const QFont font = iconFontFitSize(w, h);
+
+    painter.setFont(font);
+
+    // Center the icon to whole pixels so it stays sharp.
+    const auto flags = Qt::AlignTop | Qt::AlignLeft;
+    const auto iconText = QString(QChar(id));
+    auto boundingRect = painter.boundingRect(0, 0, w, h, flags, iconText);
+    const auto x = w - boundingRect.width();
+    // If icon is wider, assume that a tag will be rendered and align image to the right.
+    const auto pos = boundingRect.bottomLeft()
+            + ((w > h) ? QPoint(x * 3 / 4, 0) : QPoint(x / 2, 0));
+
+    // Draw shadow.
+    painter.setPen(Qt::black);
+    painter.setOpacity(0.2);
+    painter.drawText(pos + QPoint(1, 1), iconText);
+    painter.setOpacity(1);
+
+    painter.setPen(color);
+    painter.drawText(pos, iconText);
+    painter.end();
+
+    tagIcon(&pixmap, tag, tagColor);
+
+    if (iconTagId != -1)
+        addIconToAtlas(key, pixmap);
+
+    return pixmap;
+}
+
 QColor colorForMode(QPainter *painter, QIcon::Mode mode)
 {
     auto parent = painter
@@ -372,14 +442,7 @@ public:
         if (painter)
             size *= pixelRatio(painter->paintEngine()->paintDevice());
 
-        auto pixmap = doCreatePixmap(size, mode, state, painter);
-
-        if ( pixmap.isNull() ) {
-            pixmap = QPixmap(size);
-            pixmap.fill(Qt::transparent);
-        }
-
-        return taggedIcon(&pixmap);
+        return doCreateTaggedPixmap(size, mode, state, painter);
     }
 
     QList<QSize> availableSizes(QIcon::Mode, QIcon::State)
@@ -404,6 +467,21 @@ protected:
     {
     }
 
+    virtual QPixmap doCreateTaggedPixmap(QSize size, QIcon::Mode mode, QIcon::State state, QPainter *painter)
+    {
+        auto pixmap = doCreatePixmap(size, mode, state, painter);
+
+        if ( pixmap.isNull() ) {
+            pixmap = QPixmap(size);
+            pixmap.fill(Qt::transparent);
+        }
+
+        return taggedIcon(&pixmap);
+    }
+
+    const QString &tag() const { return m_tag; }
+    const QColor &tagColor() const { return m_tagColor; }
+
 private:
     virtual QPixmap doCreatePixmap(QSize size, QIcon::Mode mode, QIcon::State state, QPainter *painter) = 0;
 
@@ -442,6 +520,17 @@ public:
         return drawFontIcon( m_iconId, size.width(), size.height(), colorForMode(painter, mode) );
     }
 
+protected:
+    QPixmap doCreateTaggedPixmap(QSize size, QIcon::Mode mode, QIcon::State state, QPainter *painter) override
+    {
+        // Tagged font icons are cached.
+        if (m_iconId == 0)
+            return BaseIconEngine::doCreateTaggedPixmap(size, mode, state, painter);
+
+        return drawFontIcon(
+            m_iconId, size.width(), size.height(), colorForMode(painter, mode), tag(), tagColor() );
+    }
+
 private:
     ushort m_iconId;
 };
@@ -513,6 +602,14 @@ public:
         return FontIconEngine::doCreatePixmap(size, mode, state, painter);
     }
 
+protected:
+    QPixmap doCreateTaggedPixmap(QSize size, QIcon::Mode mode, QIcon::State state, QPainter *painter) override
+    {
+        if ( m_iconName.isEmpty() )
+            return FontIconEngine::doCreateTaggedPixmap(size, mode, state, painter);
+        return BaseIconEngine::doCreateTaggedPixmap(size, mode, state, painter);
+    }
+
 private:
     QString m_iconName;
 };
@@ -536,15 +633,13 @@ public:
         const bool useColoredIcon = !hasNormalIcon();
         const auto sessionColor = useColoredIcon ? sessionIconColor() : QColor();
 
-        const auto cacheKey = QStringLiteral("app:%1|%2x%3|%4")
-                .arg(sessionColor.name())
-                .arg(size.width())
-                .arg(size.height())
-                .arg(sessionIconTagEnabledFlag);
+        const auto key = iconAtlasKey(
+            0, size.width(), size.height(), appIconTagId,
+            sessionColor.rgba(), sessionIconTagEnabledFlag ? 1 : 0 );
 
         {
-            QPixmap pixmap;
-            if ( QPixmapCache::find(cacheKey, &pixmap) )
+            const QPixmap pixmap = findIconInAtlas(key);
+            if ( !pixmap.isNull() )
                 return pixmap;
         }
 
@@ -556,7 +651,7 @@ public:
         if (!sessionIconTagEnabledFlag)
             disableIcon(&pix);
 
-        QPixmapCache::insert(cacheKey, pix);
+        addIconToAtlas(key, pix);
 
         return pix;
     }
@@ -641,6 +736,28 @@ QPixmap createPixmap(unsigned short id, const QColor &color, int size)
     return pixmap;
 }
 
+void preloadIcons(const QWidget &widget, const QStringList &iconNames)
+{
+    if ( !loadIconFont() )
+        return;
+
+    const int extent = widget.style()->pixelMetric(QStyle::PM_SmallIconSize, nullptr, &widget);
+    const int size = static_cast<int>(extent * widget.devicePixelRatioF());
+    const QColor colors[] = {
+        getDefaultIconColor(widget, false),
+        getDefaultIconColor(widget, true),
+    };
+
+    for (const auto &iconName : iconNames) {
+        const ushort id = toIconId(iconName);
+        if (id == 0)
+            continue;
+
+        for (const auto &color : colors)
+            drawFontIcon(id, size, size, color);
+    }
+}
+
 QIcon appIcon()
 {
     return IconEngine::createIcon();
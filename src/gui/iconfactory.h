@@ -5,6 +5,7 @@
 
 #include <QColor>
 #include <QString>
+#include <QStringList>
 
 class QIcon;
 class QPixmap;
@@ -26,6 +27,13 @@ unsigned short toIconId(const QString &fileNameOrId);
 
 QPixmap createPixmap(unsigned short id, const QColor &color, int size);
 
+/**
+ * Render font icons in advance for given widget (in normal and selected mode).
+ *
+ * Icons which are not from icon font are skipped.
+ */
+void preloadIcons(const QWidget &widget, const QStringList &iconNames);
+
 /// Return app icon (color is calculated from session name).
 QIcon appIcon();
 
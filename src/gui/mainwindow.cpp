@@ -14,6 +14,7 @@
 #include "common/display.h"
 #include "common/globalshortcutcommands.h"
 #include "common/log.h"
+#include "common/metrics.h"
 #include "common/mimetypes.h"
 #include "common/shortcuts.h"
 #include "common/tabs.h"
@@ -44,7 +45,9 @@
 #include "gui/theme.h"
 #include "gui/traymenu.h"
 #include "gui/windowgeometryguard.h"
+#include "item/itemarchive.h"
 #include "item/itemfactory.h"
+#include "item/itemstore.h"
 #include "item/serialize.h"
 #include "platform/platformclipboard.h"
 #include "platform/platformnativeinterface.h"
@@ -70,6 +73,7 @@
 #include <QMimeData>
 #include <QModelIndex>
 #include <QPushButton>
+#include <QSaveFile>
 #include <QShortcut>
 #include <QTemporaryFile>
 #include <QTimer>
@@ -78,6 +82,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <vector>
 
 namespace {
 
@@ -661,6 +666,7 @@ MainWindow::MainWindow(const ClipboardBrowserSharedPtr &sharedData, QWidget *par
     initSingleShotTimer( &m_timerUpdatePreview, 0, this, &MainWindow::updateItemPreviewTimeout );
     initSingleShotTimer( &m_timerSaveTabPositions, 1000, this, &MainWindow::onSaveTabPositionsTimer );
     initSingleShotTimer( &m_timerRaiseLastWindowAfterMenuClosed, 50, this, &MainWindow::raiseLastWindowAfterMenuClosed);
+    initSingleShotTimer( &m_timerUnloadTabsOverMemoryLimit, 1000, this, &MainWindow::unloadTabsOverMemoryLimit );
     enableHideWindowOnUnfocus();
 
     m_trayMenu->setObjectName("TrayMenu");
@@ -1242,6 +1248,8 @@ void MainWindow::onBrowserCreated(ClipboardBrowser *browser)
     connect( browser, &ClipboardBrowser::itemWidgetCreated,
              this, &MainWindow::onItemWidgetCreated );
 
+    checkTabMemoryLimitLater();
+
     if (browserOrNull() == browser) {
         const int index = ui->tabWidget->currentIndex();
         tabChanged(index, index);
@@ -1274,6 +1282,55 @@ void MainWindow::onItemsChanged(const ClipboardBrowser *browser)
     const ClipboardBrowserPlaceholder *placeholder = getPlaceholderForTrayMenu();
     if (placeholder && placeholder->browser() == browser)
         updateTrayMenuItems();
+
+    checkTabMemoryLimitLater();
+}
+
+void MainWindow::unloadTabsOverMemoryLimit()
+{
+    const qint64 limit = m_sharedData->tabMemoryLimitBytes;
+    if (limit <= 0)
+        return;
+
+    std::vector<std::pair<ClipboardBrowserPlaceholder*, qint64>> loaded;
+    qint64 totalBytes = 0;
+    for( int i = 0; i < ui->tabWidget->count(); ++i ) {
+        ClipboardBrowserPlaceholder *placeholder = getPlaceholder(i);
+        if ( !placeholder->isDataLoaded() )
+            continue;
+
+        const qint64 bytes = placeholder->estimatedMemoryBytes();
+        totalBytes += bytes;
+        loaded.emplace_back(placeholder, bytes);
+    }
+
+    setMetricGauge("tabs_memory_bytes", totalBytes);
+    if (totalBytes <= limit)
+        return;
+
+    std::sort( loaded.begin(), loaded.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.first->lastAccessMs() < rhs.first->lastAccessMs();
+    } );
+
+    // Visible tabs and tabs with open editor are not unloaded.
+    for (const auto &entry : loaded) {
+        if (totalBytes <= limit)
+            break;
+
+        if ( entry.first->expire() ) {
+            COPYQ_LOG( QStringLiteral("Tab \"%1\": Unloaded to reduce memory usage (%2 bytes)")
+                       .arg(entry.first->tabName()).arg(entry.second) );
+            totalBytes -= entry.second;
+        }
+    }
+
+    setMetricGauge("tabs_memory_bytes", totalBytes);
+}
+
+void MainWindow::checkTabMemoryLimitLater()
+{
+    if ( m_sharedData->tabMemoryLimitBytes > 0 && !m_timerUnloadTabsOverMemoryLimit.isActive() )
+        m_timerUnloadTabsOverMemoryLimit.start();
 }
 
 void MainWindow::onInternalEditorStateChanged(const ClipboardBrowser *browser)
@@ -2314,12 +2371,21 @@ void MainWindow::updateCommands(QVector<Command> allCommands, bool forceSave)
             m_scriptCommands.append(command);
     }
 
+    saveScriptCommandsCache(m_scriptCommands);
+
     if (m_displayCommands != displayCommands) {
         m_displayItemList.clear();
         m_displayCommands = displayCommands;
         reloadBrowsers();
     }
 
+    QStringList iconNames;
+    for (const auto &command : m_menuCommands + m_trayMenuCommands)
+        iconNames.append(command.icon);
+    iconNames.removeDuplicates();
+    for ( TrayMenu *menu : {m_trayMenu, m_menu} )
+        preloadIcons(*menu, iconNames);
+
     updateContextMenu(contextMenuUpdateIntervalMsec);
     updateTrayMenuCommands();
     emit commandsSaved(commands);
@@ -2644,6 +2710,19 @@ void MainWindow::loadSettings(QSettings &settings, AppConfig *appConfig)
 
     const QStringList tabNames = savedTabs();
 
+    // On start, read data of tabs which will be loaded right away in parallel.
+    if ( ui->tabWidget->count() == 0 ) {
+        const QStringList tabsToLoad{
+            tabNames.value(0),
+            appConfig->option<Config::clipboard_tab>(),
+            appConfig->option<Config::tray_tab>(),
+        };
+        for (const auto &tabName : tabsToLoad) {
+            if ( !tabName.isEmpty() )
+                prefetchItems(tabName);
+        }
+    }
+
     // tab bar position
     const bool tabTreeEnabled = appConfig->option<Config::tab_tree>();
     ui->tabWidget->setTreeModeEnabled(tabTreeEnabled);
@@ -2710,8 +2789,10 @@ void MainWindow::loadSettings(QSettings &settings, AppConfig *appConfig)
     m_singleClickActivate = appConfig->option<Config::activate_item_with_single_click>();
 
     const auto menuStyleSheet = theme().getMenuStyleSheet();
-    m_trayMenu->setStyleSheet(menuStyleSheet);
-    m_menu->setStyleSheet(menuStyleSheet);
+    for ( TrayMenu *menu : {m_trayMenu, m_menu} ) {
+        if (menu->styleSheet() != menuStyleSheet)
+            menu->setStyleSheet(menuStyleSheet);
+    }
 
     if (m_options.nativeTrayMenu != appConfig->option<Config::native_tray_menu>())
         m_options.nativeTrayMenu = appConfig->option<Config::native_tray_menu>();
@@ -3735,24 +3816,27 @@ void MainWindow::copyItems()
 
 bool MainWindow::saveTab(const QString &fileName, int tabIndex)
 {
-    QFile file(fileName);
-    if ( !file.open(QIODevice::WriteOnly | QIODevice::Truncate) )
-        return false;
-
-    QDataStream out(&file);
-    out.setVersion(QDataStream::Qt_4_7);
-
     int i = tabIndex >= 0 ? tabIndex : ui->tabWidget->currentIndex();
     auto c = browser(i);
     if (!c)
         return false;
 
-    out << QByteArray("CopyQ v2") << c->tabName();
-    serializeData(*c->model(), &out);
+    QSaveFile file(fileName);
+    if ( !file.open(QIODevice::WriteOnly) )
+        return false;
 
-    file.close();
+    ItemArchiveWriter writer(&file);
+    bool saved = writer.writeHeader( c->tabName() );
+    const QAbstractItemModel &model = *c->model();
+    for (int row = 0; saved && row < model.rowCount(); ++row)
+        saved = writer.addItem( model.index(row, 0).data(contentType::data).toMap() );
 
-    return true;
+    if ( !saved || !writer.finish() ) {
+        file.cancelWriting();
+        return false;
+    }
+
+    return file.commit();
 }
 
 bool MainWindow::exportData()
@@ -3796,6 +3880,16 @@ void MainWindow::saveTabs()
             c->saveUnsavedItems();
     }
     ui->tabWidget->saveTabInfo();
+    waitForBackgroundSaves();
+}
+
+void MainWindow::flushPendingItems()
+{
+    for( int i = 0; i < ui->tabWidget->count(); ++i ) {
+        auto c = getPlaceholder(i)->browser();
+        if (c)
+            c->flushPendingItems();
+    }
 }
 
 bool MainWindow::loadTab(const QString &fileName)
@@ -3810,6 +3904,11 @@ bool MainWindow::loadTab(const QString &fileName)
     QByteArray header;
     QString tabName;
     in >> header >> tabName;
+    if ( isItemArchiveHeader(header) ) {
+        file.seek(0);
+        return loadTabArchive(&file);
+    }
+
     if ( !(header.startsWith("CopyQ v1") || header.startsWith("CopyQ v2")) || tabName.isEmpty() ) {
         file.close();
         return false;
@@ -3834,6 +3933,119 @@ bool MainWindow::loadTab(const QString &fileName)
     return true;
 }
 
+bool MainWindow::loadTabArchive(QFile *file)
+{
+    ItemArchiveReader reader(file);
+    QString tabName;
+    if ( !reader.readHeader(&tabName) || tabName.isEmpty() )
+        return false;
+
+    // Progress of the import is stored so it can continue if interrupted.
+    const QString progressFileName = file->fileName() + QLatin1String(".progress");
+    const qint64 archiveSize = file->size();
+    ClipboardBrowser *c = nullptr;
+    qint32 importedChunks = 0;
+    {
+        QFile progressFile(progressFileName);
+        if ( progressFile.open(QIODevice::ReadOnly) ) {
+            QDataStream progress(&progressFile);
+            QString progressTabName;
+            qint32 progressItemCount = -1;
+            qint64 progressArchiveSize = -1;
+            progress >> progressTabName >> importedChunks >> progressItemCount >> progressArchiveSize;
+            const int i = findTabIndex(progressTabName);
+            ClipboardBrowser *progressBrowser =
+                progress.status() == QDataStream::Ok && i != -1 && progressArchiveSize == archiveSize
+                ? getPlaceholder(i)->createBrowser() : nullptr;
+
+            // Continue only if the tab was not changed since the last checkpoint.
+            if ( progressBrowser && progressBrowser->length() == progressItemCount ) {
+                COPYQ_LOG( QStringLiteral("Tab \"%1\": Continuing import after %2 chunks")
+                           .arg(progressTabName, QString::number(importedChunks)) );
+                c = progressBrowser;
+            } else {
+                log( QStringLiteral("Cannot continue interrupted import from \"%1\", tab \"%2\" changed")
+                     .arg(file->fileName(), progressTabName), LogWarning );
+                importedChunks = 0;
+            }
+        }
+    }
+
+    if (!c) {
+        renameToUnique(&tabName, ui->tabWidget->tabs());
+        c = createTab(tabName, MatchExactTabName, Tabs())->createBrowser();
+    }
+
+    if ( !c || !c->loadItems() )
+        return false;
+
+    const auto saveProgress = [&](qint32 chunks) {
+        c->saveItems();
+        QSaveFile progressFile(progressFileName);
+        if ( progressFile.open(QIODevice::WriteOnly) ) {
+            QDataStream progress(&progressFile);
+            progress << c->tabName() << chunks << static_cast<qint32>(c->length()) << archiveSize;
+            progressFile.commit();
+        }
+    };
+
+    for (qint32 i = 0; i < importedChunks; ++i) {
+        if ( !reader.skipChunk() ) {
+            log( QStringLiteral("Failed to skip imported items in \"%1\": %2")
+                 .arg(file->fileName(), reader.errorString()), LogError );
+            return false;
+        }
+    }
+
+    // Save the tab and the progress only once in a while, tab can be large.
+    constexpr qint32 chunksPerCheckpoint = 64;
+
+    c->beginBatch();
+    qint32 chunks = importedChunks;
+    qint64 droppedItemCount = 0;
+    QVector<QVariantMap> items;
+    while ( reader.readChunk(&items) ) {
+        const int space = qMax(0, m_sharedData->maxItems - c->length());
+        QList<QVariantMap> dataList;
+        dataList.reserve( qMin(space, static_cast<int>(items.size())) );
+        for (int i = 0; i < space && i < items.size(); ++i)
+            dataList.append(items[i]);
+        droppedItemCount += items.size() - dataList.size();
+        items.clear();
+
+        if ( !dataList.isEmpty() && !c->addItems(dataList, -1) ) {
+            c->endBatch();
+            saveProgress(chunks);
+            return false;
+        }
+
+        ++chunks;
+        if (chunks % chunksPerCheckpoint == 0)
+            saveProgress(chunks);
+    }
+    c->endBatch();
+
+    if ( !reader.atEnd() ) {
+        log( QStringLiteral("Failed to import items from \"%1\": %2")
+             .arg(file->fileName(), reader.errorString()), LogError );
+        saveProgress(chunks);
+        return false;
+    }
+
+    if (droppedItemCount > 0) {
+        log( QStringLiteral("Tab \"%1\": Skipped %2 imported items over the item limit (%3)")
+             .arg(c->tabName(), QString::number(droppedItemCount), QString::number(m_sharedData->maxItems)),
+             LogWarning );
+    }
+
+    c->saveItems();
+    QFile::remove(progressFileName);
+
+    ui->tabWidget->setCurrentIndex( findTabIndex(c->tabName()) );
+
+    return true;
+}
+
 bool MainWindow::importDataFrom(const QString &fileName, ImportOptions options)
 {
     // Compatibility with v2.9.0 and earlier.
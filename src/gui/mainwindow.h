@@ -28,6 +28,7 @@ class CommandDialog;
 class ConfigurationManager;
 class Notification;
 class QAction;
+class QFile;
 class QMimeData;
 class SystemTrayIcon;
 class Tabs;
@@ -219,8 +220,14 @@ public:
     /** Save all unsaved tabs. */
     Q_SLOT void saveTabs();
 
+    /** Inserts items added to tabs in batches (see ClipboardBrowser::addItemsInBatch()). */
+    void flushPendingItems();
+
     /**
      * Load saved items to new tab.
+     *
+     * Interrupted import of tab archive continues in the same tab.
+     *
      * @return True only if all items were successfully loaded.
      */
     bool loadTab(const QString &fileName);
@@ -452,6 +459,10 @@ private:
     void tabChanged(int current, int previous);
     void saveTabPositions();
     void onSaveTabPositionsTimer();
+
+    /// Unloads least recently used tabs if loaded tabs use more memory than allowed.
+    void unloadTabsOverMemoryLimit();
+    void checkTabMemoryLimitLater();
     void doSaveTabPositions(AppConfig *appConfig);
     void tabsMoved(const QString &oldPrefix, const QString &newPrefix);
     void tabBarMenuRequested(QPoint pos, int tab);
@@ -622,6 +633,7 @@ private:
     bool exportDataV4(QDataStream *out, const QStringList &tabs, bool exportConfiguration, bool exportCommands);
     bool importDataV3(QDataStream *in, ImportOptions options);
     bool importDataV4(QDataStream *in, ImportOptions options);
+    bool loadTabArchive(QFile *file);
 
     const Theme &theme() const;
 
@@ -662,6 +674,7 @@ private:
     QTimer m_timerSaveTabPositions;
     QTimer m_timerHideWindowIfNotActive;
     QTimer m_timerRaiseLastWindowAfterMenuClosed;
+    QTimer m_timerUnloadTabsOverMemoryLimit;
 
     bool m_trayMenuDirty = true;
 
@@ -144,7 +144,8 @@ void NotificationDaemon::doUpdateNotificationWidgets()
             continue;
 
         notification->setOpacity(m_opacity);
-        w->setStyleSheet(m_styleSheet);
+        if (w->styleSheet() != m_styleSheet)
+            w->setStyleSheet(m_styleSheet);
         w->setMaximumSize( pointsToPixels(m_maximumWidthPoints), pointsToPixels(m_maximumHeightPoints) );
         notification->adjust();
 
@@ -21,6 +21,8 @@
 
 namespace {
 
+const char propertyThemePalette[] = "CopyQ_theme_palette";
+
 const QLatin1String defaultColorVarBase("default_bg");
 const QLatin1String defaultColorVarText("default_text");
 const QLatin1String defaultColorVarPlaceholderText("default_placeholder_text");
@@ -286,32 +288,40 @@ void Theme::decorateBrowser(QListView *c) const
 void Theme::decorateMainWindow(QWidget *mainWindow) const
 {
     QPalette palette = QApplication::palette();
+    QString cssTemplate = QStringLiteral("main_window_simple");
+
+    if ( isMainWindowThemeEnabled() ) {
+        const auto bg = color("bg");
+        const auto fg = color("fg");
+        palette.setColor( QPalette::Base, bg );
+        palette.setColor( QPalette::AlternateBase, color("alt_bg") );
+        palette.setColor( QPalette::Text, fg );
+        palette.setColor( QPalette::Window, bg );
+        palette.setColor( QPalette::WindowText, fg );
+        palette.setColor( QPalette::Button, bg );
+        palette.setColor( QPalette::ButtonText, fg );
+        palette.setColor( QPalette::Highlight, color("sel_bg") );
+        palette.setColor( QPalette::HighlightedText, color("sel_fg") );
+        cssTemplate = value("css_template_main_window").toString();
+    }
 
-    // This seems to properly reset icon colors.
-    mainWindow->setStyleSheet(QString());
-    mainWindow->setPalette(palette);
+    const QString styleSheet = getStyleSheet(cssTemplate);
 
-    if ( !isMainWindowThemeEnabled() ) {
-        const QString cssTemplate = QStringLiteral("main_window_simple");
-        mainWindow->setStyleSheet(getStyleSheet(cssTemplate));
+    // Setting style sheet re-polishes all child widgets, so avoid it if
+    // nothing changed. Palette is compared with the last one set by theme
+    // since style sheet can modify the palette of the widget.
+    const QVariant lastPalette = mainWindow->property(propertyThemePalette);
+    if ( mainWindow->styleSheet() == styleSheet
+         && lastPalette.isValid() && lastPalette.value<QPalette>() == palette )
+    {
         return;
     }
 
-    const auto bg = color("bg");
-    const auto fg = color("fg");
-    palette.setColor( QPalette::Base, bg );
-    palette.setColor( QPalette::AlternateBase, color("alt_bg") );
-    palette.setColor( QPalette::Text, fg );
-    palette.setColor( QPalette::Window, bg );
-    palette.setColor( QPalette::WindowText, fg );
-    palette.setColor( QPalette::Button, bg );
-    palette.setColor( QPalette::ButtonText, fg );
-    palette.setColor( QPalette::Highlight, color("sel_bg") );
-    palette.setColor( QPalette::HighlightedText, color("sel_fg") );
-
+    // This seems to properly reset icon colors.
+    mainWindow->setStyleSheet(QString());
     mainWindow->setPalette(palette);
-    const QString cssTemplate = value("css_template_main_window").toString();
-    mainWindow->setStyleSheet(getStyleSheet(cssTemplate));
+    mainWindow->setProperty( propertyThemePalette, QVariant::fromValue(palette) );
+    mainWindow->setStyleSheet(styleSheet);
 }
 
 void Theme::decorateScrollArea(QAbstractScrollArea *scrollArea) const
@@ -367,6 +377,8 @@ bool Theme::isAntialiasingEnabled() const
 
 void Theme::resetTheme()
 {
+    clearStyleSheetCache();
+
     m_theme["bg"]        = Option(defaultColorVarBase, "VALUE", ui ? ui->pushButtonColorBg : nullptr);
     m_theme["edit_bg"]   = Option(defaultColorVarBase, "VALUE", ui ? ui->pushButtonColorEditorBg : nullptr);
     m_theme["fg"]        = Option(defaultColorVarText, "VALUE", ui ? ui->pushButtonColorFg : nullptr);
@@ -511,6 +523,8 @@ void Theme::resetTheme()
 
 void Theme::updateTheme()
 {
+    clearStyleSheetCache();
+
     m_margins = QSize(2, 2);
 
     // search style
@@ -548,7 +562,15 @@ void Theme::decorateBrowser(QAbstractScrollArea *c) const
 {
     decorateScrollArea(c);
     const QString cssTemplate = value("css_template_items").toString();
-    c->setStyleSheet(getStyleSheet(cssTemplate));
+    const QString styleSheet = getStyleSheet(cssTemplate);
+    if ( c->styleSheet() != styleSheet )
+        c->setStyleSheet(styleSheet);
+}
+
+void Theme::clearStyleSheetCache()
+{
+    m_styleSheetCache.clear();
+    m_styleSheetTemplateCache.clear();
 }
 
 bool Theme::isMainWindowThemeEnabled() const
@@ -561,22 +583,43 @@ QString Theme::themeColorString(const QString &name) const
     return serializeColor( color(name) );
 }
 
+QString Theme::getStyleSheet(const QString &name) const
+{
+    // Style sheets depend on live values in configuration dialog.
+    if (ui)
+        return getStyleSheet(name, Values());
+
+    auto it = m_styleSheetCache.constFind(name);
+    if ( it == m_styleSheetCache.constEnd() )
+        it = m_styleSheetCache.insert( name, getStyleSheet(name, Values()) );
+    return it.value();
+}
+
 QString Theme::getStyleSheet(const QString &name, Values values, int maxRecursion) const
 {
-    const QString fileName = findThemeFile(name + ".css");
+    return parseStyleSheet(styleSheetTemplate(name), values, maxRecursion - 1);
+}
 
-    if ( fileName.isEmpty() )
-        return QString();
+QString Theme::styleSheetTemplate(const QString &name) const
+{
+    auto it = m_styleSheetTemplateCache.constFind(name);
+    if ( it != m_styleSheetTemplateCache.constEnd() )
+        return it.value();
 
-    QFile file(fileName);
-    if ( !file.open(QIODevice::ReadOnly) ) {
-        log( QString("Failed to open stylesheet \"%1\": %2")
-             .arg(fileName, file.errorString()), LogError );
-        return QString();
+    QString css;
+    const QString fileName = findThemeFile(name + ".css");
+    if ( !fileName.isEmpty() ) {
+        QFile file(fileName);
+        if ( file.open(QIODevice::ReadOnly) ) {
+            css = QString::fromUtf8( file.readAll() );
+        } else {
+            log( QString("Failed to open stylesheet \"%1\": %2")
+                 .arg(fileName, file.errorString()), LogError );
+        }
     }
 
-    const QString css = QString::fromUtf8( file.readAll() );
-    return parseStyleSheet(css, values, maxRecursion - 1);
+    m_styleSheetTemplateCache.insert(name, css);
+    return css;
 }
 
 QString Theme::parseStyleSheet(const QString &css, Values values, int maxRecursion) const
@@ -103,13 +103,21 @@ private:
     /** Return parsed color name. */
     QString themeColorString(const QString &name) const;
 
-    QString getStyleSheet(const QString &name, Values values = Values(), int maxRecursion = 8) const;
+    /** Return expanded style sheet, cached until theme changes. */
+    QString getStyleSheet(const QString &name) const;
+    QString getStyleSheet(const QString &name, Values values, int maxRecursion = 8) const;
+    /** Return unexpanded style sheet from theme file. */
+    QString styleSheetTemplate(const QString &name) const;
+    void clearStyleSheetCache();
     QString parseStyleSheet(const QString &css, Values values, int maxRecursion) const;
     QString parsePlaceholder(const QString &name, Values *values, int maxRecursion) const;
 
     QHash<QString, Option> m_theme;
     Ui::ConfigTabAppearance *ui = nullptr;
 
+    mutable QHash<QString, QString> m_styleSheetCache;
+    mutable QHash<QString, QString> m_styleSheetTemplateCache;
+
     QFont m_rowNumberFont;
     QFontMetrics m_rowNumberFontMetrics = QFontMetrics(m_rowNumberFont);
     QPalette m_rowNumberPalette;
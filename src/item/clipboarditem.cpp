@@ -167,6 +167,14 @@ unsigned int ClipboardItem::dataHash() const
     return m_hash;
 }
 
+qint64 ClipboardItem::dataBytes() const
+{
+    qint64 bytes = 0;
+    for (auto it = m_data.constBegin(); it != m_data.constEnd(); ++it)
+        bytes += it.key().size() * 2 + it.value().toByteArray().size();
+    return bytes;
+}
+
 void ClipboardItem::invalidateDataHash()
 {
     m_hash = 0;
@@ -60,6 +60,9 @@ public:
     /** Return hash for item's data. */
     unsigned int dataHash() const;
 
+    /** Return approximate size of item's data in bytes (including format names). */
+    qint64 dataBytes() const;
+
 private:
     void invalidateDataHash();
 
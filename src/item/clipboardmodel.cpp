@@ -10,33 +10,6 @@
 #include <algorithm>
 #include <functional>
 
-namespace {
-
-QList<QPersistentModelIndex> validIndeces(const QModelIndexList &indexList)
-{
-    QList<QPersistentModelIndex> list;
-    list.reserve(indexList.size());
-
-    for (const auto &index : indexList) {
-        if ( index.isValid() )
-            list.append(index);
-    }
-
-    return list;
-}
-
-int topMostRow(const QList<QPersistentModelIndex> &indexList)
-{
-    int row = indexList.value(0).row();
-
-    for (const auto &index : indexList)
-        row = qMin(row, index.row());
-
-    return row;
-}
-
-} // namespace
-
 void ClipboardItemList::move(int from, int count, int to)
 {
     if (to < from) {
@@ -51,6 +24,15 @@ void ClipboardItemList::move(int from, int count, int to)
     std::rotate(start1, start2, end2);
 }
 
+void ClipboardItemList::reorder(const QVector<int> &order)
+{
+    QList<ClipboardItem> items;
+    items.reserve( order.size() );
+    for (const int row : order)
+        items.append( m_items[row] );
+    m_items.swap(items);
+}
+
 ClipboardModel::ClipboardModel(QObject *parent)
     : QAbstractListModel(parent)
 {
@@ -83,6 +65,7 @@ bool ClipboardModel::setData(const QModelIndex &index, const QVariant &value, in
         return false;
 
     int row = index.row();
+    const qint64 oldBytes = m_clipboardList[row].dataBytes();
 
     if (role == Qt::EditRole) {
         m_clipboardList[row].setText(value.toString());
@@ -108,6 +91,8 @@ bool ClipboardModel::setData(const QModelIndex &index, const QVariant &value, in
         return false;
     }
 
+    m_dataBytes += m_clipboardList[row].dataBytes() - oldBytes;
+
     emit dataChanged(index, index);
 
     return true;
@@ -121,6 +106,7 @@ void ClipboardModel::insertItem(const QVariantMap &data, int row)
     beginInsertRows(QModelIndex(), row, row);
 
     m_clipboardList.insert(row, item);
+    m_dataBytes += item.dataBytes();
 
     endInsertRows();
 }
@@ -136,7 +122,9 @@ void ClipboardModel::insertItems(const QList<QVariantMap> &dataList, int row)
     beginInsertRows(QModelIndex(), row, row + dataList.size() - 1);
 
     for ( auto it = std::begin(dataList); it != std::end(dataList); ++it ) {
-        m_clipboardList.insert(targetRow, ClipboardItem(*it));
+        const ClipboardItem item(*it);
+        m_clipboardList.insert(targetRow, item);
+        m_dataBytes += item.dataBytes();
         ++targetRow;
     }
 
@@ -167,6 +155,8 @@ bool ClipboardModel::removeRows(int position, int rows, const QModelIndex&)
 
     beginRemoveRows(QModelIndex(), position, last);
 
+    for (int row = position; row <= last; ++row)
+        m_dataBytes -= m_clipboardList[row].dataBytes();
     m_clipboardList.remove(position, last - position + 1);
 
     endRemoveRows();
@@ -198,35 +188,56 @@ bool ClipboardModel::moveRows(
     return true;
 }
 
-void ClipboardModel::sortItems(const QModelIndexList &indexList, CompareItems *compare)
-{
-    QList<QPersistentModelIndex> list = validIndeces(indexList);
-    std::sort( list.begin(), list.end(), compare );
-    sortItems(list);
-}
-
 void ClipboardModel::sortItems(const QList<QPersistentModelIndex> &sorted)
 {
-    int targetRow = topMostRow(sorted);
-
+    const int count = rowCount();
+    QVector<bool> isSorted(count, false);
+    QVector<int> sortedRows;
+    sortedRows.reserve( sorted.size() );
     for (const auto &ind : sorted) {
-        if (ind.isValid()) {
-            const int sourceRow = ind.row();
+        if ( ind.isValid() && ind.model() == this && !isSorted[ind.row()] ) {
+            isSorted[ind.row()] = true;
+            sortedRows.append( ind.row() );
+        }
+    }
 
-            if (targetRow != sourceRow) {
-                beginMoveRows(QModelIndex(), sourceRow, sourceRow, QModelIndex(), targetRow);
-                m_clipboardList.move(sourceRow, targetRow);
-                endMoveRows();
+    if ( sortedRows.isEmpty() )
+        return;
 
-                // If the moved item was removed or moved further (as reaction on moving the item),
-                // stop sorting.
-                if (!ind.isValid() || ind.row() != targetRow)
-                    break;
-            }
+    const int targetRow = *std::min_element( sortedRows.begin(), sortedRows.end() );
 
-            ++targetRow;
-        }
+    QVector<int> order;
+    order.reserve(count);
+    for (int row = 0; row < targetRow; ++row)
+        order.append(row);
+    order.append(sortedRows);
+    for (int row = targetRow; row < count; ++row) {
+        if ( !isSorted[row] )
+            order.append(row);
     }
+
+    bool changed = false;
+    for (int row = targetRow; !changed && row < count; ++row)
+        changed = order[row] != row;
+    if (!changed)
+        return;
+
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+
+    QVector<int> newRows(count);
+    for (int row = 0; row < count; ++row)
+        newRows[ order[row] ] = row;
+
+    const QModelIndexList from = persistentIndexList();
+    QModelIndexList to;
+    to.reserve( from.size() );
+    for (const auto &index : from)
+        to.append( this->index(newRows[index.row()]) );
+
+    m_clipboardList.reorder(order);
+    changePersistentIndexList(from, to);
+
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
 }
 
 int ClipboardModel::findItem(uint itemHash) const
@@ -7,6 +7,7 @@
 
 #include <QAbstractListModel>
 #include <QList>
+#include <QVector>
 
 /**
  * Container with clipboard items.
@@ -51,6 +52,9 @@ public:
 
     void move(int from, int count, int to);
 
+    /// Reorders items so that item from row order[i] ends up on row i.
+    void reorder(const QVector<int> &order);
+
     void reserve(int maxItems)
     {
         m_items.reserve(maxItems);
@@ -80,9 +84,6 @@ private:
 class ClipboardModel final : public QAbstractListModel
 {
 public:
-    /** Return true if @a lhs is less than @a rhs. */
-    using CompareItems = bool (const QModelIndex &, const QModelIndex &);
-
     explicit ClipboardModel(QObject *parent = nullptr);
 
     /** Return number of items in model. */
@@ -109,9 +110,10 @@ public:
     void insertItems(const QList<QVariantMap> &dataList, int row);
 
     /**
-     * Sort items in ascending order.
+     * Move items to given order starting at the top-most row of the items.
+     *
+     * Other items keep their relative order. Model emits single layout change.
      */
-    void sortItems(const QModelIndexList &indexList, CompareItems *compare);
     void sortItems(const QList<QPersistentModelIndex> &sorted);
 
     /**
@@ -120,8 +122,16 @@ public:
      */
     int findItem(uint itemHash) const;
 
+    /**
+     * Return approximate size of data of all items in bytes.
+     *
+     * The value is updated whenever items are added, removed or changed.
+     */
+    qint64 dataBytes() const { return m_dataBytes; }
+
 private:
     ClipboardItemList m_clipboardList;
+    qint64 m_dataBytes = 0;
 };
 
 #endif // CLIPBOARDMODEL_H
@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "itemarchive.h"
+
+#include "item/serialize.h"
+
+#include <QCryptographicHash>
+#include <QIODevice>
+#include <QThread>
+
+#include <algorithm>
+
+namespace {
+
+const QByteArray archiveHeader("CopyQ tab archive v1");
+
+/// Uncompressed size of items in a chunk (larger items get a chunk of their own).
+constexpr qint64 chunkSizeBytes = 4 * 1024 * 1024;
+
+constexpr int compressionLevel = 6;
+
+QByteArray checksum(const QByteArray &bytes)
+{
+    return QCryptographicHash::hash(bytes, QCryptographicHash::Sha1);
+}
+
+QByteArray encodeChunk(const QVector<QVariantMap> &items)
+{
+    QByteArray itemsBytes;
+    {
+        QDataStream itemsStream(&itemsBytes, QIODevice::WriteOnly);
+        for (const auto &data : items)
+            serializeData(&itemsStream, data);
+    }
+
+    const QByteArray compressed = qCompress(itemsBytes, compressionLevel);
+    itemsBytes.clear();
+
+    QByteArray chunk;
+    QDataStream chunkStream(&chunk, QIODevice::WriteOnly);
+    chunkStream.setVersion(QDataStream::Qt_4_7);
+    chunkStream << static_cast<quint32>(items.size()) << checksum(compressed) << compressed;
+    return chunk;
+}
+
+qint64 itemSize(const QVariantMap &data)
+{
+    qint64 size = 0;
+    for (auto it = data.constBegin(); it != data.constEnd(); ++it)
+        size += it.key().size() + it.value().toByteArray().size();
+    return size;
+}
+
+} // namespace
+
+bool isItemArchiveHeader(const QByteArray &header)
+{
+    return header == archiveHeader;
+}
+
+ItemArchiveWriter::ItemArchiveWriter(QIODevice *device)
+    : m_device(device)
+    , m_stream(device)
+    , m_maxPendingChunks( static_cast<size_t>(std::max(2, QThread::idealThreadCount())) )
+{
+    m_stream.setVersion(QDataStream::Qt_4_7);
+}
+
+ItemArchiveWriter::~ItemArchiveWriter()
+{
+    for (auto &chunk : m_pendingChunks)
+        chunk.wait();
+}
+
+bool ItemArchiveWriter::writeHeader(const QString &tabName)
+{
+    m_stream << archiveHeader << tabName;
+    return m_stream.status() == QDataStream::Ok;
+}
+
+bool ItemArchiveWriter::addItem(const QVariantMap &data)
+{
+    m_items.append(data);
+    m_itemsBytes += itemSize(data);
+    if (m_itemsBytes < chunkSizeBytes)
+        return true;
+
+    startChunk();
+    return writeChunks(m_maxPendingChunks);
+}
+
+bool ItemArchiveWriter::finish()
+{
+    if ( !m_items.isEmpty() )
+        startChunk();
+
+    if ( !writeChunks(0) )
+        return false;
+
+    // End of archive.
+    m_stream << static_cast<quint32>(0) << QByteArray() << QByteArray();
+    return m_stream.status() == QDataStream::Ok;
+}
+
+void ItemArchiveWriter::startChunk()
+{
+    m_pendingChunks.push_back( std::async(std::launch::async, encodeChunk, m_items) );
+    m_items.clear();
+    m_itemsBytes = 0;
+}
+
+bool ItemArchiveWriter::writeChunks(size_t maxPendingChunks)
+{
+    while ( m_pendingChunks.size() > maxPendingChunks ) {
+        const QByteArray chunk = m_pendingChunks.front().get();
+        m_pendingChunks.pop_front();
+        if ( m_device->write(chunk) != chunk.size() )
+            return false;
+    }
+
+    return true;
+}
+
+ItemArchiveReader::ItemArchiveReader(QIODevice *device)
+    : m_stream(device)
+{
+    m_stream.setVersion(QDataStream::Qt_4_7);
+}
+
+bool ItemArchiveReader::readHeader(QString *tabName)
+{
+    QByteArray header;
+    m_stream >> header;
+    if ( m_stream.status() != QDataStream::Ok || !isItemArchiveHeader(header) ) {
+        m_errorString = QStringLiteral("Unknown archive format");
+        return false;
+    }
+
+    m_stream >> *tabName;
+    if ( m_stream.status() != QDataStream::Ok ) {
+        m_errorString = QStringLiteral("Corrupted archive header");
+        return false;
+    }
+
+    return true;
+}
+
+bool ItemArchiveReader::readChunk(QVector<QVariantMap> *items)
+{
+    quint32 itemCount;
+    QByteArray compressed;
+    if ( !readChunkData(&itemCount, &compressed) )
+        return false;
+
+    const QByteArray itemsBytes = qUncompress(compressed);
+    compressed.clear();
+    if ( itemsBytes.isEmpty() ) {
+        m_errorString = QStringLiteral("Failed to decompress chunk");
+        return false;
+    }
+
+    QDataStream itemsStream(itemsBytes);
+    items->reserve( items->size() + static_cast<int>(itemCount) );
+    for (quint32 i = 0; i < itemCount; ++i) {
+        QVariantMap data;
+        if ( !deserializeData(&itemsStream, &data) ) {
+            m_errorString = QStringLiteral("Failed to read items from chunk");
+            return false;
+        }
+        items->append(data);
+    }
+
+    return true;
+}
+
+bool ItemArchiveReader::skipChunk()
+{
+    quint32 itemCount;
+    QByteArray compressed;
+    return readChunkData(&itemCount, &compressed);
+}
+
+bool ItemArchiveReader::readChunkData(quint32 *itemCount, QByteArray *compressed)
+{
+    if (m_atEnd)
+        return false;
+
+    QByteArray expectedChecksum;
+    m_stream >> *itemCount >> expectedChecksum >> *compressed;
+    if ( m_stream.status() != QDataStream::Ok ) {
+        m_errorString = QStringLiteral("Unexpected end of archive");
+        return false;
+    }
+
+    if (*itemCount == 0) {
+        m_atEnd = true;
+        return false;
+    }
+
+    if ( checksum(*compressed) != expectedChecksum ) {
+        m_errorString = QStringLiteral("Chunk checksum mismatch");
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ITEMARCHIVE_H
+#define ITEMARCHIVE_H
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QString>
+#include <QVariantMap>
+#include <QVector>
+
+#include <deque>
+#include <future>
+
+class QIODevice;
+
+/**
+ * Archive with items of a single tab split into chunks.
+ *
+ * Archive starts with header (format name and tab name) followed by chunks.
+ * Each chunk contains item count, zlib-compressed serialized items and their
+ * SHA-1 checksum. An empty chunk marks the end of the archive so a truncated
+ * file can be recognized.
+ */
+bool isItemArchiveHeader(const QByteArray &header);
+
+/**
+ * Writes items to archive.
+ *
+ * Chunks are serialized and compressed in parallel in background while only
+ * a few chunks are kept in memory.
+ */
+class ItemArchiveWriter final {
+public:
+    explicit ItemArchiveWriter(QIODevice *device);
+
+    ~ItemArchiveWriter();
+
+    bool writeHeader(const QString &tabName);
+
+    bool addItem(const QVariantMap &data);
+
+    /// Writes all pending chunks and the end of the archive.
+    bool finish();
+
+private:
+    void startChunk();
+    bool writeChunks(size_t maxPendingChunks);
+
+    QIODevice *m_device;
+    QDataStream m_stream;
+    QVector<QVariantMap> m_items;
+    qint64 m_itemsBytes = 0;
+    size_t m_maxPendingChunks;
+    std::deque<std::future<QByteArray>> m_pendingChunks;
+};
+
+/// Reads items from archive chunk by chunk.
+class ItemArchiveReader final {
+public:
+    explicit ItemArchiveReader(QIODevice *device);
+
+    /// Reads archive header, returns false if the format is not recognized.
+    bool readHeader(QString *tabName);
+
+    /**
+     * Reads and verifies next chunk.
+     *
+     * Returns false if the chunk is corrupted or at the end of archive.
+     */
+    bool readChunk(QVector<QVariantMap> *items);
+
+    /// Skips next chunk without decompressing it.
+    bool skipChunk();
+
+    /// Returns true only if the end of the archive was reached.
+    bool atEnd() const { return m_atEnd; }
+
+    QString errorString() const { return m_errorString; }
+
+private:
+    bool readChunkData(quint32 *itemCount, QByteArray *compressed);
+
+    QDataStream m_stream;
+    bool m_atEnd = false;
+    QString m_errorString;
+};
+
+#endif // ITEMARCHIVE_H
@@ -8,6 +8,7 @@
 #include "common/sanitize_text_document.h"
 #include "common/textdata.h"
 #include "common/timer.h"
+#include "common/trace.h"
 #include "gui/clipboardbrowser.h"
 #include "gui/iconfactory.h"
 #include "item/itemfactory.h"
@@ -116,6 +117,28 @@ void ItemDelegate::rowsMoved(const QModelIndex &, int sourceStart, int sourceEnd
     updateLater();
 }
 
+void ItemDelegate::layoutAboutToBeChanged()
+{
+    m_indexesBeforeLayoutChange.clear();
+    m_indexesBeforeLayoutChange.reserve( m_items.size() );
+    for (int row = 0; static_cast<size_t>(row) < m_items.size(); ++row)
+        m_indexesBeforeLayoutChange.emplace_back( m_view->index(row) );
+}
+
+void ItemDelegate::layoutChanged()
+{
+    std::vector<Item> items( m_items.size() );
+    for (size_t oldRow = 0; oldRow < m_indexesBeforeLayoutChange.size(); ++oldRow) {
+        const auto &index = m_indexesBeforeLayoutChange[oldRow];
+        if ( index.isValid() && static_cast<size_t>(index.row()) < items.size() )
+            items[index.row()] = std::move(m_items[oldRow]);
+    }
+    m_items = std::move(items);
+    m_indexesBeforeLayoutChange.clear();
+
+    updateLater();
+}
+
 QWidget *ItemDelegate::createPreview(const QVariantMap &data, QWidget *parent)
 {
     const bool antialiasing = m_sharedData->theme.isAntialiasingEnabled();
@@ -153,6 +176,7 @@ void ItemDelegate::createItemWidget(const QModelIndex &index)
     const int row = index.row();
     ItemWidget *w = m_items[row].get();
     if (w == nullptr) {
+        COPYQ_TRACE("ItemDelegate::createItemWidget");
         auto data = m_view->itemData(index);
         data.insert(mimeCurrentTab, m_view->tabName());
         w = updateWidget(index, data);
@@ -510,6 +534,16 @@ ItemWidget *ItemDelegate::updateWidget(const QModelIndex &index, const QVariantM
     return w;
 }
 
+qint64 ItemDelegate::estimatedWidgetBytes() const
+{
+    qint64 bytes = 0;
+    for (const auto &item : m_items) {
+        if (item)
+            bytes += 4 * static_cast<qint64>(item.size.width()) * item.size.height();
+    }
+    return bytes;
+}
+
 bool ItemDelegate::invalidateHidden(QWidget *widget)
 {
     if ( widget->isVisible() && m_view->isVisible() )
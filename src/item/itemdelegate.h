@@ -7,6 +7,7 @@
 #include "gui/clipboardbrowsershared.h"
 
 #include <QItemDelegate>
+#include <QPersistentModelIndex>
 #include <QRegularExpression>
 #include <QTimer>
 
@@ -48,6 +49,9 @@ class ItemDelegate final : public QItemDelegate
 
         bool eventFilter(QObject *obj, QEvent *event) override;
 
+        /** Returns approximate memory used by created item widgets (assuming 32-bit pixels). */
+        qint64 estimatedWidgetBytes() const;
+
         /** Remove item widget if not currently visible and return true if removed. */
         bool invalidateHidden(QWidget *widget);
 
@@ -104,6 +108,8 @@ class ItemDelegate final : public QItemDelegate
         void rowsInserted(const QModelIndex &parent, int start, int end);
         void rowsMoved(const QModelIndex &parent, int sourceStart, int sourceEnd,
                        const QModelIndex &destination, int destinationRow);
+        void layoutAboutToBeChanged();
+        void layoutChanged();
 
         QWidget *createPreview(const QVariantMap &data, QWidget *parent);
 
@@ -153,6 +159,7 @@ class ItemDelegate final : public QItemDelegate
         QTimer m_timerInvalidateHidden;
 
         std::vector<Item> m_items;
+        std::vector<QPersistentModelIndex> m_indexesBeforeLayoutChange;
 };
 
 #endif // ITEMDELEGATE_H
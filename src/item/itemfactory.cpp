@@ -8,6 +8,7 @@
 #include "common/contenttype.h"
 #include "common/log.h"
 #include "common/mimetypes.h"
+#include "common/startupprofile.h"
 #include "common/textdata.h"
 #include "item/itemfilter.h"
 #include "item/itemstore.h"
@@ -193,6 +194,8 @@ public:
     {
         return serializeData(model, file);
     }
+
+    bool canSaveItemsInBackground() const override { return true; }
 };
 
 class DummyLoader final : public ItemLoaderInterface
@@ -519,6 +522,8 @@ bool ItemFactory::loadPlugins()
         auto loader = loadPlugin(path, QString());
         if (loader)
             addLoader(loader);
+        if ( isStartupProfileEnabled() )
+            startupProfileMark( QStringLiteral("load plugin %1").arg(fileName) );
     }
 
     std::sort(m_loaders.begin(), m_loaders.end(), priorityLessThan);
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <qnamespace.h>
+
 #include <memory>
 
 class QModelIndex;
+class QRegularExpression;
 class QString;
 class QTextCharFormat;
 class QTextEdit;
@@ -21,3 +24,7 @@ public:
 };
 
 using ItemFilterPtr = std::shared_ptr<ItemFilter>;
+
+ItemFilterPtr createItemFilterRegExp(const QRegularExpression &re, const QString &searchString);
+
+ItemFilterPtr createItemFilterFixedStrings(const QString &searchString, Qt::CaseSensitivity caseSensitivity);
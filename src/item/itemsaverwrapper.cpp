@@ -10,6 +10,11 @@ bool ItemSaverWrapper::saveItems(const QString &tabName, const QAbstractItemMode
     return m_saver->saveItems(tabName, model, file);
 }
 
+bool ItemSaverWrapper::canSaveItemsInBackground() const
+{
+    return m_saver->canSaveItemsInBackground();
+}
+
 bool ItemSaverWrapper::canRemoveItems(const QList<QModelIndex> &indexList, QString *error)
 {
     return m_saver->canRemoveItems(indexList, error);
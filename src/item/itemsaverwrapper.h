@@ -9,6 +9,8 @@ public:
 
     bool saveItems(const QString &tabName, const QAbstractItemModel &model, QIODevice *file) override;
 
+    bool canSaveItemsInBackground() const override;
+
     bool canRemoveItems(const QList<QModelIndex> &indexList, QString *error) override;
 
     bool canDropItem(const QModelIndex &index) override;
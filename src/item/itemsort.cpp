@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "itemsort.h"
+
+#include "common/contenttype.h"
+#include "common/textdata.h"
+
+#include <QVariantMap>
+
+#include <algorithm>
+#include <future>
+
+namespace {
+
+/// Minimal number of items sorted by a single worker task.
+constexpr int minItemsPerSortTask = 10000;
+
+QString formatSortKey(const QVariantMap &dataMap, const QString &format, const QRegularExpression &re)
+{
+    const QString text = format.isEmpty()
+        ? getTextData(dataMap)
+        : getTextData(dataMap, format);
+    if ( re.pattern().isEmpty() )
+        return text;
+
+    const auto match = re.match(text);
+    if ( !match.hasMatch() )
+        return QString();
+
+    return match.captured( match.lastCapturedIndex() > 0 ? 1 : 0 );
+}
+
+qint64 dataSize(const QVariantMap &dataMap)
+{
+    qint64 size = 0;
+    for (const auto &value : dataMap)
+        size += value.toByteArray().size();
+    return size;
+}
+
+} // namespace
+
+ItemSorter::ItemSorter(
+        const QList<QPersistentModelIndex> &indexes, ItemSortKey key,
+        const QString &format, const QRegularExpression &re)
+    : m_key(key)
+{
+    m_indexes.reserve( indexes.size() );
+    for (const auto &index : indexes) {
+        if ( index.isValid() )
+            m_indexes.append(index);
+    }
+
+    const auto size = static_cast<size_t>( m_indexes.size() );
+    m_order.reserve(size);
+    for (int i = 0; i < m_indexes.size(); ++i)
+        m_order.push_back(i);
+
+    switch (m_key) {
+    case ItemSortKey::Text: {
+        QCollator collator;
+        m_textKeys.reserve(size);
+        for (const auto &index : m_indexes)
+            m_textKeys.push_back( collator.sortKey(index.data(contentType::text).toString()) );
+        break;
+    }
+    case ItemSortKey::Format:
+        m_stringKeys.reserve(size);
+        for (const auto &index : m_indexes)
+            m_stringKeys.push_back( formatSortKey(index.data(contentType::data).toMap(), format, re) );
+        break;
+    case ItemSortKey::Size:
+        m_numberKeys.reserve(size);
+        for (const auto &index : m_indexes)
+            m_numberKeys.push_back( dataSize(index.data(contentType::data).toMap()) );
+        break;
+    case ItemSortKey::Reverse:
+        m_numberKeys.reserve(size);
+        for (const auto &index : m_indexes)
+            m_numberKeys.push_back( -index.row() );
+        break;
+    }
+}
+
+void ItemSorter::sort()
+{
+    const auto lessThan = [this](int lhs, int rhs) { return this->lessThan(lhs, rhs); };
+    const int itemCount = size();
+    const int taskCount = qMax(1, qMin(QThread::idealThreadCount(), itemCount / minItemsPerSortTask));
+    if (taskCount == 1) {
+        std::stable_sort(m_order.begin(), m_order.end(), lessThan);
+        return;
+    }
+
+    // Sort parts in parallel and merge them (both steps keep the sort stable).
+    std::vector<int> bounds;
+    for (int i = 0; i <= taskCount; ++i)
+        bounds.push_back( static_cast<int>(static_cast<qint64>(itemCount) * i / taskCount) );
+
+    const auto begin = m_order.begin();
+    std::vector<std::future<void>> tasks;
+    for (int i = 0; i < taskCount; ++i) {
+        tasks.push_back( std::async(std::launch::async, [&, i]() {
+            std::stable_sort(begin + bounds[i], begin + bounds[i + 1], lessThan);
+        }) );
+    }
+    for (auto &task : tasks)
+        task.get();
+
+    for (int step = 1; step < taskCount; step *= 2) {
+        for (int i = 0; i + step < taskCount; i += 2 * step) {
+            const int last = std::min(i + 2 * step, taskCount);
+            std::inplace_merge(begin + bounds[i], begin + bounds[i + step], begin + bounds[last], lessThan);
+        }
+    }
+}
+
+QList<QPersistentModelIndex> ItemSorter::sorted() const
+{
+    QList<QPersistentModelIndex> result;
+    result.reserve( m_indexes.size() );
+    for (const int i : m_order) {
+        if ( m_indexes[i].isValid() )
+            result.append(m_indexes[i]);
+    }
+    return result;
+}
+
+bool ItemSorter::lessThan(int lhs, int rhs) const
+{
+    switch (m_key) {
+    case ItemSortKey::Text:
+        return m_textKeys[lhs].compare(m_textKeys[rhs]) < 0;
+    case ItemSortKey::Format:
+        return m_stringKeys[lhs] < m_stringKeys[rhs];
+    case ItemSortKey::Size:
+    case ItemSortKey::Reverse:
+        return m_numberKeys[lhs] < m_numberKeys[rhs];
+    }
+    return false;
+}
+
+ItemSortThread::ItemSortThread(ItemSorter &&sorter, QObject *parent)
+    : QThread(parent)
+    , m_sorter(std::move(sorter))
+{
+}
+
+ItemSortThread::~ItemSortThread()
+{
+    wait();
+}
+
+void ItemSortThread::run()
+{
+    m_sorter.sort();
+}
@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ITEMSORT_H
+#define ITEMSORT_H
+
+#include <QCollator>
+#include <QList>
+#include <QPersistentModelIndex>
+#include <QRegularExpression>
+#include <QString>
+#include <QThread>
+
+#include <vector>
+
+enum class ItemSortKey {
+    /// Item text compared in locale-aware manner.
+    Text,
+    /// Text in given format (or its part matched by regular expression).
+    Format,
+    /// Size of item data in bytes.
+    Size,
+    /// Current row, newest (top) items last.
+    Reverse,
+};
+
+/**
+ * Sorts items by keys extracted only once from the model.
+ *
+ * Keys are extracted in constructor which must be called in the thread owning
+ * the model. The sort() itself does not access the model and can run in any
+ * thread.
+ */
+class ItemSorter final {
+public:
+    ItemSorter(
+        const QList<QPersistentModelIndex> &indexes, ItemSortKey key,
+        const QString &format = QString(),
+        const QRegularExpression &re = QRegularExpression());
+
+    int size() const { return static_cast<int>(m_order.size()); }
+
+    /// Stable sort, splits work between multiple threads for many items.
+    void sort();
+
+    /// Returns valid indexes in sorted order.
+    QList<QPersistentModelIndex> sorted() const;
+
+private:
+    bool lessThan(int lhs, int rhs) const;
+
+    ItemSortKey m_key;
+    QList<QPersistentModelIndex> m_indexes;
+    std::vector<QCollatorSortKey> m_textKeys;
+    std::vector<QString> m_stringKeys;
+    std::vector<qint64> m_numberKeys;
+    std::vector<int> m_order;
+};
+
+/// Runs ItemSorter::sort() in a worker thread.
+class ItemSortThread final : public QThread {
+public:
+    ItemSortThread(ItemSorter &&sorter, QObject *parent);
+
+    ~ItemSortThread();
+
+    /// Returns sorter (safe to access only after the thread finished).
+    const ItemSorter &sorter() const { return m_sorter; }
+
+protected:
+    void run() override;
+
+private:
+    ItemSorter m_sorter;
+};
+
+#endif // ITEMSORT_H
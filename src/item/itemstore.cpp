@@ -3,23 +3,116 @@
 #include "itemstore.h"
 
 #include "common/config.h"
+#include "common/contenttype.h"
 #include "common/log.h"
+#include "common/metrics.h"
+#include "common/startupprofile.h"
 #include "common/textdata.h"
+#include "common/trace.h"
+#include "item/clipboardmodel.h"
 #include "item/itemfactory.h"
 
 #include <QAbstractItemModel>
+#include <QBuffer>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QSaveFile>
+#include <QTimer>
+
+#include <condition_variable>
+#include <future>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
 
 namespace {
 
-/// @return File name for data file with items.
-QString itemFileName(const QString &id)
+/// Unused tab data read on start are dropped after this time since the first tab loaded.
+const int dropPrefetchedTabFilesDelayMs = 10000;
+
+/// Tab files being read in background (accessed only from main thread).
+std::map<QString, std::future<QByteArray>> &prefetchedTabFiles()
 {
-    QString part( id.toUtf8().toBase64() );
-    part.replace( QChar('/'), QString('-') );
-    return getConfigurationFilePath("_tab_") + part + QLatin1String(".dat");
+    static std::map<QString, std::future<QByteArray>> files;
+    return files;
+}
+
+QByteArray readTabFile(const QString &tabFileName)
+{
+    QFile tabFile(tabFileName);
+    if ( !tabFile.open(QIODevice::ReadOnly) )
+        return QByteArray();
+    return tabFile.readAll();
+}
+
+void dropPrefetchedTabFiles()
+{
+    auto &files = prefetchedTabFiles();
+    if ( !files.empty() ) {
+        COPYQ_LOG( QString("Dropping %1 unused tab data read on start").arg(files.size()) );
+        files.clear();
+    }
+}
+
+QByteArray takePrefetchedTabFile(const QString &tabFileName)
+{
+    auto &files = prefetchedTabFiles();
+    const auto it = files.find(tabFileName);
+    if ( it == files.end() )
+        return QByteArray();
+
+    const QByteArray bytes = it->second.get();
+    files.erase(it);
+
+    // Tabs not loaded soon after start may never be opened.
+    static bool dropScheduled = false;
+    if ( !dropScheduled && !files.empty() ) {
+        dropScheduled = true;
+        QTimer::singleShot(dropPrefetchedTabFilesDelayMs, dropPrefetchedTabFiles);
+    }
+
+    return bytes;
+}
+
+/// Snapshot of items to save in background.
+struct PendingSave {
+    QList<QVariantMap> items;
+    ItemSaverPtr saver;
+};
+
+/// Tabs being saved in background threads.
+struct BackgroundSaves {
+    std::mutex mutex;
+    std::condition_variable finished;
+    /// Tabs with a running save thread.
+    std::set<QString> running;
+    /// Newest items to save for each tab, older snapshots are dropped.
+    std::map<QString, PendingSave> pending;
+};
+
+BackgroundSaves &backgroundSaves()
+{
+    static BackgroundSaves saves;
+    return saves;
+}
+
+/// Waits for background save of the tab, optionally dropping unsaved snapshot.
+void waitForBackgroundSave(const QString &tabName, bool dropPending)
+{
+    auto &saves = backgroundSaves();
+    std::unique_lock<std::mutex> lock(saves.mutex);
+    if (dropPending)
+        saves.pending.erase(tabName);
+    saves.finished.wait(lock, [&]() { return saves.running.count(tabName) == 0; });
+}
+
+bool hasBackgroundSave(const QString &tabName)
+{
+    auto &saves = backgroundSaves();
+    std::lock_guard<std::mutex> lock(saves.mutex);
+    return saves.running.count(tabName) > 0;
 }
 
 bool createItemDirectory()
@@ -53,6 +146,24 @@ ItemSaverPtr loadItems(
 {
     COPYQ_LOG( QString("Tab \"%1\": Loading items from: %2").arg(tabName, tabFileName) );
 
+    QByteArray bytes = takePrefetchedTabFile(tabFileName);
+    if ( !bytes.isEmpty() ) {
+        const QByteArray originalBytes = bytes;
+        QBuffer buffer(&bytes);
+        buffer.open(QIODevice::ReadOnly);
+        auto saver = itemFactory->loadItems(tabName, &model, &buffer, maxItems);
+
+        // Loader can reopen the device for writing to repair the tab data
+        // (e.g. to keep readable part of a corrupted tab).
+        if ( saver && bytes != originalBytes ) {
+            QSaveFile tabFile(tabFileName);
+            if ( !tabFile.open(QIODevice::WriteOnly) || tabFile.write(bytes) != bytes.size() || !tabFile.commit() )
+                printItemFileError("load tab (rewrite)", tabName, tabFile);
+        }
+
+        return saver;
+    }
+
     QFile tabFile(tabFileName);
     if ( !tabFile.open(QIODevice::ReadOnly) ) {
         printItemFileError("load tab", tabName, tabFile);
@@ -62,6 +173,17 @@ ItemSaverPtr loadItems(
     return itemFactory->loadItems(tabName, &model, &tabFile, maxItems);
 }
 
+void updateTabMetrics(const QString &tabName, const QAbstractItemModel &model)
+{
+    if ( !isMetricsEnabled() )
+        return;
+
+    setMetricGauge("tab_items", tabName, model.rowCount());
+    const auto clipboardModel = dynamic_cast<const ClipboardModel*>(&model);
+    if (clipboardModel)
+        setMetricGauge("tab_payload_bytes", tabName, clipboardModel->dataBytes());
+}
+
 ItemSaverPtr createTab(
         const QString &tabName, QAbstractItemModel &model, ItemFactory *itemFactory, int maxItems)
 {
@@ -79,32 +201,13 @@ ItemSaverPtr createTab(
     return saver;
 }
 
-} // namespace
-
-ItemSaverPtr loadItems(const QString &tabName, QAbstractItemModel &model, ItemFactory *itemFactory, int maxItems)
+bool saveItemsToFile(const QString &tabName, const QAbstractItemModel &model, const ItemSaverPtr &saver)
 {
-    if ( !createItemDirectory() )
-        return nullptr;
-
-    const QString tabFileName = itemFileName(tabName);
-    if ( !QFile::exists(tabFileName) )
-        return createTab(tabName, model, itemFactory, maxItems);
+    COPYQ_TRACE_DETAIL("saveItems", tabName.toUtf8());
 
-    ItemSaverPtr saver = loadItems(tabName, tabFileName, model, itemFactory, maxItems);
-    if (saver) {
-        COPYQ_LOG( QStringLiteral("Tab \"%1\": %2 items loaded from: %3")
-                      .arg(tabName, QString::number(model.rowCount()), tabFileName) );
-        return saver;
-    }
+    QElapsedTimer elapsed;
+    elapsed.start();
 
-    log( QStringLiteral("Tab \"%1\": Failed to load tab file: %2")
-            .arg(tabName, tabFileName), LogError );
-    model.removeRows(0, model.rowCount());
-    return nullptr;
-}
-
-bool saveItems(const QString &tabName, const QAbstractItemModel &model, const ItemSaverPtr &saver)
-{
     const QString tabFileName = itemFileName(tabName);
 
     if ( !createItemDirectory() )
@@ -133,26 +236,177 @@ bool saveItems(const QString &tabName, const QAbstractItemModel &model, const It
         return false;
     }
 
+    const qint64 savedBytes = tabFile.size();
+
     if ( !tabFile.commit() ) {
         printItemFileError("save tab (commit)", tabName, tabFile);
         return false;
     }
 
+    addMetricLatency("tab_save_ms", elapsed.elapsed());
+    addMetricCount("tab_save_bytes", savedBytes);
+    updateTabMetrics(tabName, model);
+
     COPYQ_LOG( QStringLiteral("Tab \"%1\": Items saved").arg(tabName) );
 
     return true;
 }
 
+void runBackgroundSaves(const QString &tabName)
+{
+    auto &saves = backgroundSaves();
+    std::unique_lock<std::mutex> lock(saves.mutex);
+
+    for (;;) {
+        const auto it = saves.pending.find(tabName);
+        if ( it == saves.pending.end() )
+            break;
+
+        PendingSave pendingSave = std::move(it->second);
+        saves.pending.erase(it);
+        lock.unlock();
+
+        {
+            ClipboardModel model;
+            model.insertItems(pendingSave.items, 0);
+            pendingSave.items.clear();
+            saveItemsToFile(tabName, model, pendingSave.saver);
+        }
+
+        // Owner of the saver waits for the save to finish,
+        // so the saver is never destroyed in this thread.
+        pendingSave.saver.reset();
+
+        lock.lock();
+    }
+
+    saves.running.erase(tabName);
+    saves.finished.notify_all();
+}
+
+} // namespace
+
+QString itemFileName(const QString &id)
+{
+    QString part( id.toUtf8().toBase64() );
+    part.replace( QChar('/'), QString('-') );
+    return getConfigurationFilePath("_tab_") + part + QLatin1String(".dat");
+}
+
+void prefetchItems(const QString &tabName)
+{
+    // File being saved would be read before the save finishes.
+    if ( hasBackgroundSave(tabName) )
+        return;
+
+    const QString tabFileName = itemFileName(tabName);
+    auto &files = prefetchedTabFiles();
+    if ( files.find(tabFileName) != files.end() || !QFile::exists(tabFileName) )
+        return;
+
+    COPYQ_LOG( QString("Tab \"%1\": Reading items in background").arg(tabName) );
+    files[tabFileName] = std::async(std::launch::async, readTabFile, tabFileName);
+}
+
+ItemSaverPtr loadItems(const QString &tabName, QAbstractItemModel &model, ItemFactory *itemFactory, int maxItems)
+{
+    COPYQ_TRACE_DETAIL("loadItems", tabName.toUtf8());
+
+    waitForBackgroundSave(tabName, false);
+
+    if ( !createItemDirectory() )
+        return nullptr;
+
+    const QString tabFileName = itemFileName(tabName);
+    if ( !QFile::exists(tabFileName) )
+        return createTab(tabName, model, itemFactory, maxItems);
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    ItemSaverPtr saver = loadItems(tabName, tabFileName, model, itemFactory, maxItems);
+    if (saver) {
+        addMetricLatency("tab_load_ms", elapsed.elapsed());
+        updateTabMetrics(tabName, model);
+        if ( isStartupProfileEnabled() ) {
+            startupProfileMark( QStringLiteral("load tab \"%1\" (%2 items)")
+                                .arg(tabName).arg(model.rowCount()) );
+        }
+        COPYQ_LOG( QStringLiteral("Tab \"%1\": %2 items loaded from: %3")
+                      .arg(tabName, QString::number(model.rowCount()), tabFileName) );
+        return saver;
+    }
+
+    log( QStringLiteral("Tab \"%1\": Failed to load tab file: %2")
+            .arg(tabName, tabFileName), LogError );
+    model.removeRows(0, model.rowCount());
+    return nullptr;
+}
+
+bool saveItems(const QString &tabName, const QAbstractItemModel &model, const ItemSaverPtr &saver)
+{
+    // Newer items are saved now, older snapshot must not overwrite them.
+    waitForBackgroundSave(tabName, true);
+    return saveItemsToFile(tabName, model, saver);
+}
+
+void saveItemsInBackground(const QString &tabName, const QAbstractItemModel &model, const ItemSaverPtr &saver)
+{
+    if ( !saver->canSaveItemsInBackground() ) {
+        saveItems(tabName, model, saver);
+        return;
+    }
+
+    // Item data are implicitly shared so the snapshot is cheap.
+    PendingSave pendingSave;
+    pendingSave.saver = saver;
+    const int rowCount = model.rowCount();
+    pendingSave.items.reserve(rowCount);
+    for (int row = 0; row < rowCount; ++row)
+        pendingSave.items.append( model.index(row, 0).data(contentType::data).toMap() );
+
+    auto &saves = backgroundSaves();
+    std::lock_guard<std::mutex> lock(saves.mutex);
+
+    auto it = saves.pending.find(tabName);
+    if ( it == saves.pending.end() ) {
+        saves.pending.emplace( tabName, std::move(pendingSave) );
+    } else {
+        it->second = std::move(pendingSave);
+        addMetricCount("tab_saves_coalesced");
+    }
+
+    if ( saves.running.count(tabName) > 0 )
+        return;
+
+    saves.running.insert(tabName);
+    std::thread(runBackgroundSaves, tabName).detach();
+}
+
+void waitForBackgroundSaves()
+{
+    auto &saves = backgroundSaves();
+    std::unique_lock<std::mutex> lock(saves.mutex);
+    saves.finished.wait(lock, [&]() { return saves.running.empty(); });
+}
+
 void removeItems(const QString &tabName)
 {
+    waitForBackgroundSave(tabName, true);
     const QString tabFileName = itemFileName(tabName);
+    prefetchedTabFiles().erase(tabFileName);
     QFile::remove(tabFileName);
+    removeMetricGaugeLabel("tab_items", tabName);
+    removeMetricGaugeLabel("tab_payload_bytes", tabName);
 }
 
 bool moveItems(const QString &oldId, const QString &newId)
 {
+    waitForBackgroundSave(oldId, false);
+    waitForBackgroundSave(newId, true);
     const QString oldFileName = itemFileName(oldId);
     const QString newFileName = itemFileName(newId);
+    prefetchedTabFiles().erase(oldFileName);
+    prefetchedTabFiles().erase(newFileName);
 
     if ( oldFileName != newFileName && QFile::copy(oldFileName, newFileName) ) {
         QFile::remove(oldFileName);
@@ -8,6 +8,18 @@ class QAbstractItemModel;
 class ItemFactory;
 class QString;
 
+/** Return path to data file with items for a tab. */
+QString itemFileName(const QString &id //!< See ClipboardBrowser::getID().
+        );
+
+/**
+ * Start reading configuration file with items in a background thread.
+ *
+ * Following loadItems() for the tab uses the data instead of reading the file.
+ * Data not used shortly after the first tab is loaded are dropped.
+ */
+void prefetchItems(const QString &tabName);
+
 /** Load items from configuration file. */
 ItemSaverPtr loadItems(const QString &tabName, QAbstractItemModel &model //!< Model for items.
         , ItemFactory *itemFactory, int maxItems);
@@ -16,6 +28,20 @@ ItemSaverPtr loadItems(const QString &tabName, QAbstractItemModel &model //!< Mo
 bool saveItems(const QString &tabName, const QAbstractItemModel &model //!< Model containing items to save.
         , const ItemSaverPtr &saver);
 
+/**
+ * Save items to configuration file in a background thread.
+ *
+ * Items are copied from the model first. If the tab is already being saved,
+ * only the newest items are saved afterwards.
+ *
+ * Saves in the current thread if the saver does not support it.
+ */
+void saveItemsInBackground(const QString &tabName, const QAbstractItemModel &model
+        , const ItemSaverPtr &saver);
+
+/** Wait for all background saves to finish. */
+void waitForBackgroundSaves();
+
 /** Remove configuration file for items. */
 void removeItems(const QString &tabName //!< See ClipboardBrowser::getID().
         );
@@ -182,6 +182,11 @@ bool ItemSaverInterface::saveItems(const QString &, const QAbstractItemModel &,
     return false;
 }
 
+bool ItemSaverInterface::canSaveItemsInBackground() const
+{
+    return false;
+}
+
 bool ItemSaverInterface::canRemoveItems(const QList<QModelIndex> &, QString *)
 {
     return true;
@@ -30,7 +30,7 @@ using ItemSaverPtr = std::shared_ptr<ItemSaverInterface>;
 class ItemScriptableFactoryInterface;
 using ItemScriptableFactoryPtr = std::shared_ptr<ItemScriptableFactoryInterface>;
 
-#define COPYQ_PLUGIN_ITEM_LOADER_ID "com.github.hluk.copyq.itemloader/7.0.0"
+#define COPYQ_PLUGIN_ITEM_LOADER_ID "com.github.hluk.copyq.itemloader/7.1.0"
 
 /**
  * Handles item in list.
@@ -181,6 +181,12 @@ public:
      */
     virtual bool saveItems(const QString &tabName, const QAbstractItemModel &model, QIODevice *file);
 
+    /**
+     * Return true if saveItems() can be called from a background thread
+     * with a copy of the model.
+     */
+    virtual bool canSaveItemsInBackground() const;
+
     /**
      * Called before items are deleted by user.
      * @return true if items can be removed, false to cancel the removal
@@ -198,6 +198,37 @@ QByteArray serializeData(const QVariantMap &data)
     return bytes;
 }
 
+void serializeData(const QVariantMap &data, QVector<QByteArray> *chunks)
+{
+    QByteArray header;
+    QDataStream stream(&header, QIODevice::WriteOnly);
+    stream << static_cast<qint32>(-2);
+
+    const qint32 size = data.size();
+    stream << size;
+
+    for (auto it = data.constBegin(); it != data.constEnd(); ++it) {
+        const QByteArray bytes = it.value().toByteArray();
+        stream << compressMime(it.key())
+               << /* compressData = */ false;
+
+        // Large sizes and null data are serialized differently.
+        if ( bytes.isEmpty() || static_cast<quint64>(bytes.size()) >= 0xfffffffeu ) {
+            stream << bytes;
+            continue;
+        }
+
+        stream << static_cast<quint32>(bytes.size());
+        chunks->append(header);
+        chunks->append(bytes);
+        header.clear();
+        stream.device()->seek(0);
+    }
+
+    if ( !header.isEmpty() )
+        chunks->append(header);
+}
+
 bool deserializeData(QVariantMap *data, const QByteArray &bytes)
 {
     QDataStream out(bytes);
@@ -4,6 +4,7 @@
 #define SERIALIZE_H
 
 #include <QVariantMap>
+#include <QVector>
 
 class QAbstractItemModel;
 class QByteArray;
@@ -13,6 +14,12 @@ class QIODevice;
 void serializeData(QDataStream *stream, const QVariantMap &data);
 bool deserializeData(QDataStream *stream, QVariantMap *data);
 QByteArray serializeData(const QVariantMap &data);
+
+/**
+ * Serializes data same as serializeData(data) but into separate chunks
+ * so that format payloads are shared instead of copied.
+ */
+void serializeData(const QVariantMap &data, QVector<QByteArray> *chunks);
 bool deserializeData(QVariantMap *data, const QByteArray &bytes);
 
 bool serializeData(const QAbstractItemModel &model, QDataStream *stream);
@@ -7,6 +7,7 @@
 #include "common/commandstatus.h"
 #include "common/log.h"
 #include "common/messagehandlerforqt.h"
+#include "common/startupprofile.h"
 #include "common/textdata.h"
 #include "platform/platformnativeinterface.h"
 #ifdef Q_OS_UNIX
@@ -103,6 +104,7 @@ int startServer(int argc, char *argv[], QString sessionName)
         qputenv("QT_AUTO_SCREEN_SCALE_FACTOR", "1");
 
     auto qapp = platformNativeInterface()->createServerApplication(argc, argv);
+    startupProfileMark("create application");
     if ( qapp->isSessionRestored() ) {
         const auto sessionId = qapp->sessionId();
         sessionName = restoreSessionName(sessionId);
@@ -171,6 +173,11 @@ bool needsStartServer(const QString &arg)
     return arg == "--start-server";
 }
 
+bool needsStartupProfile(const QString &arg)
+{
+    return arg == "--startup-profile";
+}
+
 #ifdef HAS_TESTS
 bool needsTests(const QString &arg)
 {
@@ -233,6 +240,11 @@ int startApplication(int argc, char **argv)
                 : startClient(argc, argv, arguments.mid(skipArguments + 1), sessionName);
         }
 
+        if ( needsStartupProfile(arg) ) {
+            enableStartupProfile();
+            return startServer(argc, argv, sessionName);
+        }
+
         if ( needsVersion(arg) )
             return evaluate( "version", QStringList(), argc, argv, sessionName );
 
@@ -10,16 +10,24 @@
 #include <QBuffer>
 #include <QDebug>
 #include <QElapsedTimer>
+#include <QEventLoop>
 #include <QFile>
 #include <QGuiApplication>
+#include <QHash>
 #include <QImageReader>
 #include <QImageWriter>
 #include <QMimeData>
+#include <QPointer>
+#include <QSocketNotifier>
 #include <QThread>
+#include <QTimer>
 #include <QtWaylandClient/QWaylandClientExtension>
 #include <qpa/qplatformnativeinterface.h>
 #include <qtwaylandclientversion.h>
 
+#include <algorithm>
+#include <functional>
+
 #include <errno.h>
 #include <fcntl.h>
 #include <poll.h>
@@ -102,57 +110,82 @@ private:
     int m_fd;
 };
 
-class ReceiveThread : public QThread {
+/**
+ * Reads data from a pipe in the event loop (without blocking or busy waiting).
+ */
+class PipeReader : public QObject {
 public:
-    ReceiveThread(int fd)
-        : m_fd(fd)
-    {}
+    PipeReader(int fd, std::function<void(const QByteArray &)> onFinished, QObject *parent)
+        : QObject(parent)
+        , m_fd(fd)
+        , m_notifier(fd, QSocketNotifier::Read)
+        , m_onFinished(std::move(onFinished))
+    {
+        fcntl(m_fd, F_SETFL, fcntl(m_fd, F_GETFL) | O_NONBLOCK);
 
-    QByteArray data() const { return m_data; }
+        connect(&m_notifier, &QSocketNotifier::activated, this, [this]() { readAvailable(); });
 
-protected:
-    void run() override {
-        QFile readPipe;
-        if (readPipe.open(m_fd, QIODevice::ReadOnly, QFile::AutoCloseHandle)) {
-            readData();
+        m_timeout.setSingleShot(true);
+        m_timeout.setInterval(1000);
+        connect(&m_timeout, &QTimer::timeout, this, [this]() {
+            qWarning("DataControlOffer: timeout reading from pipe");
+            finish();
+        });
+        m_timeout.start();
+    }
+
+    ~PipeReader()
+    {
+        if (m_fd != -1)
             close(m_fd);
-        }
     }
 
 private:
-    void readData() {
-        pollfd pfds[1];
-        pfds[0].fd = m_fd;
-        pfds[0].events = POLLIN;
-
+    void readAvailable()
+    {
+        // Read big chunks directly to the result buffer until the pipe is drained.
+        constexpr int chunkSize = 256 * 1024;
         while (true) {
-            const int ready = poll(pfds, 1, 1000);
-            if (ready < 0) {
-                if (errno != EINTR) {
-                    qWarning("DataControlOffer: poll() failed: %s", strerror(errno));
-                    return;
-                }
-            } else if (ready == 0) {
-                qWarning("DataControlOffer: timeout reading from pipe");
-                return;
-            } else {
-                char buf[4096];
-                int n = read(m_fd, buf, sizeof buf);
+            const int oldSize = m_data.size();
+            m_data.resize(oldSize + chunkSize);
+            const ssize_t n = read(m_fd, m_data.data() + oldSize, chunkSize);
+            m_data.resize(oldSize + std::max<ssize_t>(n, 0));
+
+            if (n > 0) {
+                m_timeout.start();
+                continue;
+            }
 
-                if (n < 0) {
-                    qWarning("DataControlOffer: read() failed: %s", strerror(errno));
-                    return;
-                } else if (n == 0) {
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
                     return;
-                } else if (n > 0) {
-                    m_data.append(buf, n);
-                }
+                qWarning("DataControlOffer: read() failed: %s", strerror(errno));
             }
+
+            finish();
+            return;
         }
     }
 
-    QByteArray m_data;
+    void finish()
+    {
+        if (m_fd == -1)
+            return;
+
+        m_timeout.stop();
+        m_notifier.setEnabled(false);
+        close(m_fd);
+        m_fd = -1;
+        m_onFinished(m_data);
+    }
+
     int m_fd;
+    QSocketNotifier m_notifier;
+    QTimer m_timeout;
+    QByteArray m_data;
+    std::function<void(const QByteArray &)> m_onFinished;
 };
 
 } // namespace
@@ -246,6 +279,17 @@ public:
         return false;
     }
 
+    /**
+     * Starts receiving data in given formats at once.
+     *
+     * Data are read concurrently in the event loop and kept until
+     * retrieved with retrieveData().
+     */
+    void requestData(const QStringList &mimeTypes);
+
+Q_SIGNALS:
+    void dataReceived(const QString &mime);
+
 protected:
     void zwlr_data_control_offer_v1_offer(const QString &mime_type) override
     {
@@ -259,68 +303,105 @@ protected:
 #endif
 
 private:
+    QString resolveMimeType(const QString &mimeType) const;
+    QByteArray waitForData(const QString &mime);
+
     QStringList m_receivedFormats;
+    QHash<QString, QByteArray> m_data;
+    QHash<QString, PipeReader*> m_readers;
 };
 
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-QVariant DataControlOffer::retrieveData(const QString &mimeType, QMetaType type) const
-#else
-QVariant DataControlOffer::retrieveData(const QString &mimeType, QVariant::Type type) const
-#endif
+QString DataControlOffer::resolveMimeType(const QString &mimeType) const
 {
-    Q_UNUSED(type);
+    if (m_receivedFormats.contains(mimeType))
+        return mimeType;
 
-    QString mime;
-    if (!m_receivedFormats.contains(mimeType)) {
-        if (mimeType == QStringLiteral("text/plain") && m_receivedFormats.contains(utf8Text())) {
-            mime = utf8Text();
-        } else if (mimeType == applicationQtXImageLiteral()) {
-            const auto writeFormats = imageWriteMimeFormats();
-            for (const auto &receivedFormat : m_receivedFormats) {
-                if (writeFormats.contains(receivedFormat)) {
-                    mime = receivedFormat;
-                    break;
-                }
-            }
-            if (mime.isEmpty()) {
-                // default exchange format
-                mime = QStringLiteral("image/png");
-            }
-        }
+    if (mimeType == QStringLiteral("text/plain") && m_receivedFormats.contains(utf8Text()))
+        return utf8Text();
 
-        if (mime.isEmpty()) {
-            return QVariant();
+    if (mimeType == applicationQtXImageLiteral()) {
+        const auto writeFormats = imageWriteMimeFormats();
+        for (const auto &receivedFormat : m_receivedFormats) {
+            if (writeFormats.contains(receivedFormat))
+                return receivedFormat;
         }
-    } else {
-        mime = mimeType;
+        // default exchange format
+        return QStringLiteral("image/png");
     }
 
-    int pipeFds[2];
-    if (pipe(pipeFds) != 0) {
-        return QVariant();
+    return QString();
+}
+
+void DataControlOffer::requestData(const QStringList &mimeTypes)
+{
+    bool requested = false;
+    for (const auto &mimeType : mimeTypes) {
+        const QString mime = resolveMimeType(mimeType);
+        if (mime.isEmpty() || m_data.contains(mime) || m_readers.contains(mime))
+            continue;
+
+        int pipeFds[2];
+        if (pipe(pipeFds) != 0) {
+            qWarning("DataControlOffer: pipe() failed: %s", strerror(errno));
+            continue;
+        }
+
+        receive(mime, pipeFds[1]);
+        close(pipeFds[1]);
+
+        m_readers[mime] = new PipeReader(pipeFds[0], [this, mime](const QByteArray &data) {
+            m_data[mime] = data;
+            m_readers.take(mime)->deleteLater();
+            Q_EMIT dataReceived(mime);
+        }, this);
+        requested = true;
     }
 
-    auto t = const_cast<DataControlOffer *>(this);
-    t->receive(mime, pipeFds[1]);
+    // Send all requests to the data source at once.
+    if (requested) {
+        QPlatformNativeInterface *native = qGuiApp->platformNativeInterface();
+        auto display = static_cast<struct ::wl_display *>(native->nativeResourceForIntegration("wl_display"));
+        wl_display_flush(display);
+    }
+}
 
-    close(pipeFds[1]);
+QByteArray DataControlOffer::waitForData(const QString &mime)
+{
+    if ( m_readers.contains(mime) ) {
+        // The data source can be in this process, so events must be processed.
+        QPointer<DataControlOffer> self(this);
+        QEventLoop loop;
+        connect(this, &DataControlOffer::dataReceived, &loop, [&](const QString &receivedMime) {
+            if (receivedMime == mime)
+                loop.quit();
+        });
+        connect(this, &QObject::destroyed, &loop, &QEventLoop::quit);
+        loop.exec();
+
+        if (!self)
+            return QByteArray();
+    }
+
+    // Release the data once retrieved; the caller keeps its own copy.
+    return m_data.take(mime);
+}
 
-    /*
-     * Ideally we need to introduce a non-blocking QMimeData object
-     * Or a non-blocking constructor to QMimeData with the mimetypes that are relevant
-     *
-     * However this isn't actually any worse than X.
-     */
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+QVariant DataControlOffer::retrieveData(const QString &mimeType, QMetaType type) const
+#else
+QVariant DataControlOffer::retrieveData(const QString &mimeType, QVariant::Type type) const
+#endif
+{
+    Q_UNUSED(type);
 
-    QPlatformNativeInterface *native = qGuiApp->platformNativeInterface();
-    auto display = static_cast<struct ::wl_display *>(native->nativeResourceForIntegration("wl_display"));
-    wl_display_flush(display);
+    const QString mime = resolveMimeType(mimeType);
+    if (mime.isEmpty()) {
+        return QVariant();
+    }
 
-    ReceiveThread thread(pipeFds[0]);
-    thread.start();
-    while (thread.isRunning())
-        QCoreApplication::processEvents();
-    const auto data = thread.data();
+    auto t = const_cast<DataControlOffer *>(this);
+    t->requestData({mime});
+    const auto data = t->waitForData(mime);
 
     if (!data.isEmpty() && mimeType == applicationQtXImageLiteral()) {
         QImage img = QImage::fromData(data, mime.mid(mime.indexOf(QLatin1Char('/')) + 1).toLatin1().toUpper().data());
@@ -448,7 +529,7 @@ public:
     }
 
     void setSelection(std::unique_ptr<DataControlSource> selection);
-    QMimeData *receivedSelection()
+    DataControlOffer *receivedSelection()
     {
         return m_receivedSelection.get();
     }
@@ -458,7 +539,7 @@ public:
     }
 
     void setPrimarySelection(std::unique_ptr<DataControlSource> selection);
-    QMimeData *receivedPrimarySelection()
+    DataControlOffer *receivedPrimarySelection()
     {
         return m_receivedPrimarySelection.get();
     }
@@ -659,6 +740,24 @@ const QMimeData *WaylandClipboard::mimeData(QClipboard::Mode mode) const
     return nullptr;
 }
 
+void WaylandClipboard::requestData(QClipboard::Mode mode, const QStringList &formats)
+{
+    if (!m_device) {
+        return;
+    }
+
+    // Locally set selection is available without receiving.
+    DataControlOffer *offer = nullptr;
+    if (mode == QClipboard::Clipboard && !m_device->selection()) {
+        offer = m_device->receivedSelection();
+    } else if (mode == QClipboard::Selection && !m_device->primarySelection()) {
+        offer = m_device->receivedPrimarySelection();
+    }
+    if (offer) {
+        offer->requestData(formats);
+    }
+}
+
 bool WaylandClipboard::isSelectionSupported() const
 {
     return m_device && zwlr_data_control_device_v1_get_version(m_device->object())
@@ -7,6 +7,7 @@
 #pragma once
 #include <QClipboard>
 #include <QObject>
+#include <QStringList>
 #include <memory>
 
 class DataControlDevice;
@@ -28,6 +29,15 @@ public:
     bool isActive() const { return m_device != nullptr; }
     bool isSelectionSupported() const;
 
+    /**
+     * Starts receiving all given formats from the current clipboard owner at once.
+     *
+     * Data are read concurrently in the event loop. Accessing the data from
+     * mimeData() still waits, but only until the specific format arrives, so
+     * reading all formats takes about as long as the slowest one.
+     */
+    void requestData(QClipboard::Mode mode, const QStringList &formats);
+
 signals:
     void changed(QClipboard::Mode mode);
 
@@ -44,6 +44,33 @@ bool isSelectionIncomplete()
     return event.xbutton.state & (Button1Mask | ShiftMask);
 }
 
+/// Returns selection owner window or 0 (cheap, no data is transferred).
+unsigned long selectionOwnerWindow(ClipboardMode mode)
+{
+    if (!X11Info::isPlatformX11())
+        return 0;
+
+    auto display = X11Info::display();
+    if (mode == ClipboardMode::Selection)
+        return XGetSelectionOwner(display, XA_PRIMARY);
+
+    static const Atom clipboardAtom = XInternAtom(display, "CLIPBOARD", False);
+    return XGetSelectionOwner(display, clipboardAtom);
+}
+
+quint32 selectionTimestamp(const QMimeData &data)
+{
+    const QByteArray timestampData = data.data(QLatin1String("TIMESTAMP"));
+    if ( timestampData.isEmpty() )
+        return 0;
+
+    quint32 timestamp = 0;
+    QDataStream stream(timestampData);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream >> timestamp;
+    return stream.status() == QDataStream::Ok ? timestamp : 0;
+}
+
 } // namespace
 
 X11PlatformClipboard::X11PlatformClipboard()
@@ -83,6 +110,7 @@ void X11PlatformClipboard::startMonitoring(const QStringList &formats)
     for (auto clipboardData : {&m_clipboardData, &m_selectionData}) {
         clipboardData->owner.clear();
         clipboardData->newOwner.clear();
+        clipboardData->ownerWindow = 0;
         updateClipboardData(clipboardData);
         useNewClipboardData(clipboardData);
     }
@@ -207,8 +235,13 @@ void X11PlatformClipboard::check()
 
     m_timerCheckAgain.stop();
 
-    updateClipboardData(&m_clipboardData);
-    updateClipboardData(&m_selectionData);
+    for (auto clipboardData : {&m_clipboardData, &m_selectionData}) {
+        // Avoid transferring all data again if the owner, targets and
+        // valid timestamp did not change since last time.
+        if ( isOwnerAndTargetsUnchanged(*clipboardData) )
+            continue;
+        updateClipboardData(clipboardData);
+    }
 
     if ( m_timerCheckAgain.isActive() )
         return;
@@ -222,6 +255,23 @@ void X11PlatformClipboard::check()
     checkAgainLater(changed, interval);
 }
 
+bool X11PlatformClipboard::isOwnerAndTargetsUnchanged(const ClipboardData &clipboardData) const
+{
+    if ( !clipboardData.enabled || clipboardData.ownerWindow == 0 )
+        return false;
+
+    if ( selectionOwnerWindow(clipboardData.mode) != clipboardData.ownerWindow )
+        return false;
+
+    const auto data = mimeData(clipboardData.mode);
+    if ( !data || data->formats() != clipboardData.targets )
+        return false;
+
+    // Without timestamp the content can change while owner and targets stay the same.
+    const quint32 timestamp = selectionTimestamp(*data);
+    return timestamp != 0 && timestamp == clipboardData.newDataTimestamp;
+}
+
 void X11PlatformClipboard::updateClipboardData(X11PlatformClipboard::ClipboardData *clipboardData)
 {
     if (!clipboardData->enabled)
@@ -253,15 +303,7 @@ void X11PlatformClipboard::updateClipboardData(X11PlatformClipboard::ClipboardDa
     }
     clipboardData->retry = 0;
 
-    const QByteArray newDataTimestampData = data->data(QLatin1String("TIMESTAMP"));
-    quint32 newDataTimestamp = 0;
-    if ( !newDataTimestampData.isEmpty() ) {
-        QDataStream stream(newDataTimestampData);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream >> newDataTimestamp;
-        if (stream.status() != QDataStream::Ok)
-            newDataTimestamp = 0;
-    }
+    const quint32 newDataTimestamp = selectionTimestamp(*data);
 
     // In case there is a valid timestamp, omit update if the timestamp and
     // text did not change.
@@ -271,17 +313,31 @@ void X11PlatformClipboard::updateClipboardData(X11PlatformClipboard::ClipboardDa
             return;
     }
 
+    // Owner is fetched before the data so a change during cloning is not missed.
+    const auto ownerWindow = selectionOwnerWindow(clipboardData->mode);
+    const QStringList targets = data->formats();
+
+    // Receive all formats concurrently instead of one after another.
+    if ( !X11Info::isPlatformX11() ) {
+        WaylandClipboard::instance()->requestData(
+            modeToQClipboardMode(clipboardData->mode), clipboardData->formats);
+    }
+
     clipboardData->timerEmitChange.stop();
     clipboardData->abortCloning = false;
     clipboardData->cloningData = true;
     clipboardData->newData = cloneData(*data, clipboardData->formats, &clipboardData->abortCloning);
     clipboardData->cloningData = false;
     if (clipboardData->abortCloning) {
+        clipboardData->ownerWindow = 0;
         m_timerCheckAgain.setInterval(0);
         m_timerCheckAgain.start();
         return;
     }
 
+    clipboardData->ownerWindow = ownerWindow;
+    clipboardData->targets = targets;
+
     // In case there is no timestamp, update only if the data changed.
     if ( newDataTimestamp == 0 && clipboardData->data == clipboardData->newData )
         return;
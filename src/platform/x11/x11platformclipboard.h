@@ -39,6 +39,9 @@ private:
         QByteArray newOwner;
         QTimer timerEmitChange;
         QStringList formats;
+        // Selection owner window and targets when data was last retrieved.
+        unsigned long ownerWindow = 0;
+        QStringList targets;
         quint32 newDataTimestamp;
         ClipboardMode mode;
         bool enabled = true;
@@ -48,6 +51,7 @@ private:
     };
 
     void check();
+    bool isOwnerAndTargetsUnchanged(const ClipboardData &clipboardData) const;
     void updateClipboardData(ClipboardData *clipboardData);
     void useNewClipboardData(ClipboardData *clipboardData);
     void checkAgainLater(bool clipboardChanged, int interval);
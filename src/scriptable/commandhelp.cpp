@@ -186,5 +186,9 @@ QList<CommandHelp> commandHelp()
             << CommandHelp("--start-server",
                            Scriptable::tr("Start server in background before running a command."))
                .addArg("[" + Scriptable::tr("COMMAND") + "]")
+            << CommandHelp("--session-pipe",
+                           Scriptable::tr("Run commands from standard input (one per line) and print results as JSON."))
+            << CommandHelp("--startup-profile",
+                           Scriptable::tr("Start server and print time spent in startup phases."))
                ;
 }
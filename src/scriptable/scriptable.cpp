@@ -12,6 +12,7 @@
 #include "common/sleeptimer.h"
 #include "common/version.h"
 #include "common/textdata.h"
+#include "common/trace.h"
 #include "gui/clipboardspy.h"
 #include "gui/icons.h"
 #include "item/itemfactory.h"
@@ -25,6 +26,7 @@
 #include "scriptable/scriptableproxy.h"
 #include "scriptable/scriptablesettings.h"
 #include "scriptable/scriptabletemporaryfile.h"
+#include "scriptable/simplecommand.h"
 
 #include <QApplication>
 #include <QCryptographicHash>
@@ -402,9 +404,9 @@ struct ScriptValueFactory<QVariant> {
 
     static QVariant fromScriptValue(const QJSValue &value, const Scriptable *scriptable)
     {
-        const auto bytes = getByteArray(value);
-        if (bytes)
-            return QVariant(*bytes);
+        QByteArray bytes;
+        if ( getByteArray(value, &bytes) )
+            return QVariant(bytes);
 
         auto file = getFile(value, scriptable);
         if (file) {
@@ -456,11 +458,10 @@ QByteArray serializeScriptValue(const QJSValue &value, Scriptable *scriptable)
 {
     QByteArray data;
 
-    const QByteArray *bytes = getByteArray(value);
+    if ( getByteArray(value, &data) )
+        return data;
 
-    if (bytes != nullptr) {
-        data = *bytes;
-    } else if ( value.isArray() || value.toVariant().type() == QVariant::StringList ) {
+    if ( value.isArray() || value.toVariant().type() == QVariant::StringList ) {
         const quint32 len = value.property("length").toUInt();
         for (quint32 i = 0; i < len; ++i)
             data += serializeScriptValue(value.property(i), scriptable);
@@ -471,33 +472,6 @@ QByteArray serializeScriptValue(const QJSValue &value, Scriptable *scriptable)
     return data;
 }
 
-QString parseCommandLineArgument(const QString &arg)
-{
-    QString result;
-    bool escape = false;
-
-    for (const auto &c : arg) {
-        if (escape) {
-            escape = false;
-
-            if (c == 'n')
-                result.append('\n');
-            else if (c == 't')
-                result.append('\t');
-            else if (c == '\\')
-                result.append('\\');
-            else
-                result.append(c);
-        } else if (c == '\\') {
-            escape = true;
-        } else {
-            result.append(c);
-        }
-    }
-
-    return result;
-}
-
 bool matchData(const QRegularExpression &re, const QVariantMap &data, const QString &format)
 {
     if ( re.pattern().isEmpty() )
@@ -676,7 +650,7 @@ Scriptable::Scriptable(
                 "var v = from[name]();"
                 "delete _copyqArguments;"
                 "if (_copyqHasUncaughtException) throw _copyqUncaughtException;"
-                "return ByteArray(v);"
+                "return useArrayBuffer ? v : ByteArray(v);"
             "}"
         "})"
     ));
@@ -718,6 +692,10 @@ QJSValue Scriptable::argument(int index) const
 
 QJSValue Scriptable::newByteArray(const QByteArray &bytes) const
 {
+    // ArrayBuffer shares the data with QByteArray (copy on write).
+    if (m_useArrayBuffer)
+        return m_engine->toScriptValue(bytes);
+
     return m_engine->newQObject(new ScriptableByteArray(bytes));
 }
 
@@ -765,24 +743,25 @@ QJSValue Scriptable::fromDataMap(const QVariantMap &dataMap) const
 
 QByteArray Scriptable::makeByteArray(const QJSValue &value) const
 {
-    const QByteArray *data = getByteArray(value);
-    return data ? *data : fromString(value.toString());
+    QByteArray data;
+    return getByteArray(value, &data) ? data : fromString(value.toString());
 }
 
 bool Scriptable::toItemData(const QJSValue &value, const QString &mime, QVariantMap *data) const
 {
     if (mime == mimeItems) {
-        const QByteArray *itemData = getByteArray(value);
-        if (!itemData)
+        QByteArray itemData;
+        if ( !getByteArray(value, &itemData) )
             return false;
 
-        return deserializeData(data, *itemData);
+        return deserializeData(data, itemData);
     }
 
+    QByteArray bytes;
     if (value.isUndefined())
         data->insert( mime, QVariant() );
-    else if (!mime.startsWith("text/") && getByteArray(value) )
-        data->insert( mime, *getByteArray(value) );
+    else if ( !mime.startsWith("text/") && getByteArray(value, &bytes) )
+        data->insert( mime, bytes );
     else
         data->insert( mime, toString(value).toUtf8() );
 
@@ -799,6 +778,16 @@ void Scriptable::setInputSeparator(const QJSValue &separator)
     m_inputSeparator = toString(separator);
 }
 
+QJSValue Scriptable::getUseArrayBuffer() const
+{
+    return m_useArrayBuffer;
+}
+
+void Scriptable::setUseArrayBuffer(const QJSValue &enabled)
+{
+    m_useArrayBuffer = enabled.toBool();
+}
+
 QString Scriptable::getCurrentPath() const
 {
     return QDir::currentPath();
@@ -1326,6 +1315,20 @@ QJSValue Scriptable::remove()
     return QJSValue();
 }
 
+void Scriptable::beginBatch()
+{
+    m_skipArguments = 0;
+    m_proxy->browserBeginBatch(m_tabName);
+    m_batchTabs.append(m_tabName);
+}
+
+void Scriptable::endBatch()
+{
+    m_skipArguments = 0;
+    if ( !m_batchTabs.isEmpty() )
+        m_proxy->browserEndBatch( m_batchTabs.takeLast() );
+}
+
 QJSValue Scriptable::move()
 {
     m_skipArguments = 1;
@@ -1784,7 +1787,7 @@ QJSValue Scriptable::input()
 {
     m_skipArguments = 0;
 
-    if ( !getByteArray(m_input) )
+    if ( !isByteArray(m_input) )
         m_input = readInput();
 
     return m_input;
@@ -1951,6 +1954,30 @@ QJSValue Scriptable::logs()
     return QString::fromUtf8(readLogFile(50 * 1024 * 1024));
 }
 
+QJSValue Scriptable::metrics()
+{
+    m_skipArguments = 0;
+    return QString::fromUtf8(m_proxy->metrics());
+}
+
+void Scriptable::traceStart()
+{
+    m_skipArguments = 0;
+    m_proxy->traceStart();
+}
+
+QJSValue Scriptable::traceStop()
+{
+    m_skipArguments = 1;
+
+    const QString path = getAbsoluteFilePath(arg(0));
+    const QString error = m_proxy->traceStop(path);
+    if ( !error.isEmpty() )
+        return throwError(error);
+
+    return QJSValue();
+}
+
 void Scriptable::setCurrentTab()
 {
     m_skipArguments = 1;
@@ -2125,7 +2152,7 @@ QJSValue Scriptable::execute()
         if ( arg.isCallable() )
             m_executeStdoutCallback = arg;
         else
-            action.setInput( action.input() + makeByteArray(arg) );
+            action.appendInput( makeByteArray(arg) );
     }
 
     action.setCommand(args);
@@ -2885,7 +2912,11 @@ void Scriptable::onSynchronizeSelection(ClipboardMode sourceMode, uint sourceTex
 
 bool Scriptable::sourceScriptCommands()
 {
-    const auto commands = m_proxy->scriptCommands();
+    // Avoid round-trip to server if it already cached the commands.
+    Commands commands;
+    if ( !loadScriptCommandsCache(&commands) )
+        commands = m_proxy->scriptCommands();
+
     for (const auto &command : commands) {
         const auto script = QStringLiteral("(function(){%1\n;})()").arg(command.cmd);
         const auto label = QStringLiteral("source@<%1>").arg(command.name);
@@ -3117,7 +3148,7 @@ QVector<QVariantMap> Scriptable::getItemList(int begin, int end, const QJSValue
 
     for (int i = begin; i < end; ++i) {
         const auto arg = arguments.property( static_cast<quint32>(i) );
-        if ( arg.isObject() && getByteArray(arg) == nullptr && !arg.isArray() )
+        if ( arg.isObject() && !isByteArray(arg) && !arg.isArray() )
             items.append( fromScriptValue<QVariantMap>(arg, this) );
         else
             items.append( createDataMap(mimeText, toString(arg)) );
@@ -3240,6 +3271,7 @@ QJSValue Scriptable::screenshot(bool select)
 
 QJSValue Scriptable::eval(const QString &script, const QString &label)
 {
+    COPYQ_TRACE_DETAIL("Scriptable::eval", label.toUtf8());
     m_stack.prepend(QStringLiteral("eval:") + label);
     COPYQ_LOG_VERBOSE( QStringLiteral("Stack push: %1").arg(m_stack.join('|')) );
     const auto result = m_safeEval.call({QJSValue(script)});
@@ -3270,6 +3302,17 @@ void Scriptable::setActionName(const QString &actionName)
     m_actionName = actionName;
 }
 
+void Scriptable::setOutputBuffers(QByteArray *output, QByteArray *errorOutput)
+{
+    m_output = output;
+    m_errorOutput = errorOutput;
+}
+
+void Scriptable::setInput(const QByteArray &input)
+{
+    m_input = newByteArray(input);
+}
+
 QJSValue Scriptable::eval(const QString &script)
 {
     return eval(script, scriptToLabel(script));
@@ -3525,6 +3568,8 @@ void Scriptable::print(const QByteArray &message)
 {
     if (m_action) {
         m_action->appendOutput(message);
+    } else if (m_output) {
+        m_output->append(message);
     } else if ( canUseStandardOutput() ) {
         QFile f;
         f.open(stdout, QIODevice::WriteOnly);
@@ -3536,6 +3581,10 @@ void Scriptable::printError(const QByteArray &message)
 {
     if (m_action) {
         m_action->appendErrorOutput(message);
+    } else if (m_errorOutput) {
+        m_errorOutput->append(message);
+        if ( !message.endsWith('\n') )
+            m_errorOutput->append('\n');
     } else if ( canUseStandardOutput() ) {
         QFile f;
         f.open(stderr, QIODevice::WriteOnly);
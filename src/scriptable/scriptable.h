@@ -33,6 +33,7 @@ class Scriptable final : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(QJSValue inputSeparator READ getInputSeparator WRITE setInputSeparator)
+    Q_PROPERTY(QJSValue useArrayBuffer READ getUseArrayBuffer WRITE setUseArrayBuffer)
     Q_PROPERTY(QJSValue mimeText READ getMimeText CONSTANT)
     Q_PROPERTY(QJSValue mimeTextUtf8 READ getMimeTextUtf8 CONSTANT)
     Q_PROPERTY(QJSValue mimeHtml READ getMimeHtml CONSTANT)
@@ -95,6 +96,9 @@ public:
     QJSValue getInputSeparator() const;
     void setInputSeparator(const QJSValue &separator);
 
+    QJSValue getUseArrayBuffer() const;
+    void setUseArrayBuffer(const QJSValue &enabled);
+
     QString getCurrentPath() const;
     void setCurrentPath(const QString &path);
 
@@ -144,6 +148,13 @@ public:
 
     void setActionId(int actionId);
     void setActionName(const QString &actionName);
+
+    /// Appends printed output to buffers instead of standard output.
+    void setOutputBuffers(QByteArray *output, QByteArray *errorOutput);
+
+    /// Sets data returned by input() instead of reading standard input.
+    void setInput(const QByteArray &input);
+
     int executeArguments(const QStringList &args);
     int executeArgumentsSimple(const QStringList &args);
 
@@ -202,6 +213,8 @@ public slots:
     void add();
     void insert();
     QJSValue remove();
+    void beginBatch();
+    void endBatch();
     void edit();
     QJSValue move();
 
@@ -252,6 +265,11 @@ public slots:
     void serverLog();
     QJSValue logs();
 
+    void traceStart();
+    QJSValue traceStop();
+
+    QJSValue metrics();
+
     void setCurrentTab();
 
     QJSValue selectItems();
@@ -453,6 +471,8 @@ private:
     QJSEngine *m_engine;
     QJSValue m_temporaryFileClass;
     QString m_inputSeparator;
+    QStringList m_batchTabs;
+    bool m_useArrayBuffer = false;
     QJSValue m_input;
     QVariantMap m_data;
     QVariantMap m_oldData;
@@ -471,6 +491,8 @@ private:
     QJSValue m_plugins;
 
     Action *m_action = nullptr;
+    QByteArray *m_output = nullptr;
+    QByteArray *m_errorOutput = nullptr;
     bool m_failed = false;
 
     QString m_tabName;
@@ -6,6 +6,7 @@
 
 #include <QJSEngine>
 #include <QJSValue>
+#include <QVariant>
 
 ScriptableByteArray::ScriptableByteArray(const QByteArray &bytes)
     : m_self(bytes)
@@ -129,21 +130,60 @@ QJSValue ScriptableByteArray::newByteArray(const QByteArray &bytes) const
     return engine()->newQObject( new ScriptableByteArray(bytes) );
 }
 
-const QByteArray *getByteArray(const QJSValue &value)
+bool getByteArray(const QJSValue &value, QByteArray *bytes)
 {
-    const auto obj1 = value.toQObject();
-    const auto obj = qobject_cast<ScriptableByteArray*>(obj1);
-    return obj ? obj->data() : nullptr;
+    if ( !value.isObject() || value.isArray() )
+        return false;
+
+    if ( value.isQObject() ) {
+        const auto byteArray = qobject_cast<ScriptableByteArray*>(value.toQObject());
+        if (byteArray == nullptr)
+            return false;
+        *bytes = *byteArray->data();
+        return true;
+    }
+
+    // Only ArrayBuffer, typed arrays and DataView have "byteLength".
+    const QJSValue byteLength = value.property(QStringLiteral("byteLength"));
+    if ( !byteLength.isNumber() )
+        return false;
+
+    // ArrayBuffer converts to QByteArray which shares the data.
+    const QJSValue buffer = value.property(QStringLiteral("buffer"));
+    if ( buffer.isUndefined() ) {
+        const QVariant variant = value.toVariant();
+        if ( variant.type() != QVariant::ByteArray )
+            return false;
+        *bytes = variant.toByteArray();
+        return true;
+    }
+
+    const QVariant variant = buffer.toVariant();
+    if ( variant.type() != QVariant::ByteArray )
+        return false;
+
+    const QByteArray bufferBytes = variant.toByteArray();
+    const int offset = value.property(QStringLiteral("byteOffset")).toInt();
+    const int length = byteLength.toInt();
+    *bytes = (offset == 0 && length == bufferBytes.size())
+        ? bufferBytes : bufferBytes.mid(offset, length);
+    return true;
+}
+
+bool isByteArray(const QJSValue &value)
+{
+    QByteArray bytes;
+    return getByteArray(value, &bytes);
 }
 
 QByteArray toByteArray(const QJSValue &value)
 {
-    const auto byteArray = qobject_cast<ScriptableByteArray*>(value.toQObject());
-    return byteArray ? *byteArray->data() : value.toString().toUtf8();
+    QByteArray bytes;
+    return getByteArray(value, &bytes) ? bytes : value.toString().toUtf8();
 }
 
 QString toString(const QJSValue &value)
 {
-    const QByteArray *bytes = getByteArray(value);
-    return (bytes == nullptr) ? value.toString() : getTextData(*bytes);
+    QByteArray bytes;
+    return getByteArray(value, &bytes) ? getTextData(bytes) : value.toString();
 }
@@ -54,7 +54,14 @@ private:
     QByteArray m_self;
 };
 
-const QByteArray *getByteArray(const QJSValue &value);
+/**
+ * Returns true if value is ByteArray, ArrayBuffer or typed array (like Uint8Array).
+ *
+ * The bytes share data with the value (copy on write).
+ */
+bool getByteArray(const QJSValue &value, QByteArray *bytes);
+
+bool isByteArray(const QJSValue &value);
 
 QByteArray toByteArray(const QJSValue &value);
 
@@ -68,6 +68,11 @@ QRegularExpression toRegularExpression(const QJSValue &value)
     return regexp;
 }
 
+QString optionalString(const QJSValue &value)
+{
+    return value.isUndefined() || value.isNull() ? QString() : toString(value);
+}
+
 } // namespace
 
 ScriptableItemSelection::ScriptableItemSelection(const QString &tabName)
@@ -259,6 +264,45 @@ QJSValue ScriptableItemSelection::sort(QJSValue compareFn)
     return m_self;
 }
 
+QJSValue ScriptableItemSelection::sortBy(const QJSValue &format, const QJSValue &re)
+{
+    const QVariant regexp = re.isUndefined() ? QVariant() : toRegularExpression(re);
+    m_proxy->selectionSortBy(m_id, optionalString(format), regexp);
+    return m_self;
+}
+
+QJSValue ScriptableItemSelection::filter(const QJSValue &re, const QString &mimeFormat)
+{
+    const QVariant regexp = re.isUndefined() ? QVariant() : toRegularExpression(re);
+    m_proxy->selectionFilter(m_id, regexp, mimeFormat);
+    return m_self;
+}
+
+QJSValue ScriptableItemSelection::filterSize(const QJSValue &minSize, const QJSValue &maxSize, const QString &mimeFormat)
+{
+    const qint64 minSize2 = minSize.isUndefined() ? 0 : static_cast<qint64>(minSize.toNumber());
+    const qint64 maxSize2 = maxSize.isUndefined() ? -1 : static_cast<qint64>(maxSize.toNumber());
+    m_proxy->selectionFilterSize(m_id, minSize2, maxSize2, mimeFormat);
+    return m_self;
+}
+
+QJSValue ScriptableItemSelection::mapFormat(const QJSValue &format, const QJSValue &transform, const QJSValue &targetFormat)
+{
+    const QString transformName = ::toString(transform);
+    if ( !m_proxy->selectionMapFormat(m_id, ::toString(format), transformName, optionalString(targetFormat)) ) {
+#if QT_VERSION >= QT_VERSION_CHECK(5,12,0)
+        qjsEngine(this)->throwError( QStringLiteral("Unknown transform: %1").arg(transformName) );
+#endif
+    }
+    return m_self;
+}
+
+QJSValue ScriptableItemSelection::removeDuplicates(const QJSValue &format)
+{
+    m_proxy->selectionRemoveDuplicates(m_id, optionalString(format));
+    return m_self;
+}
+
 void ScriptableItemSelection::init(const QJSValue &self, ScriptableProxy *proxy, const QString &currentTabName)
 {
     m_self = self;
@@ -57,6 +57,12 @@ public slots:
 
     QJSValue sort(QJSValue compareFn);
 
+    QJSValue sortBy(const QJSValue &format, const QJSValue &re = QJSValue());
+    QJSValue filter(const QJSValue &re, const QString &mimeFormat = QString());
+    QJSValue filterSize(const QJSValue &minSize, const QJSValue &maxSize = QJSValue(), const QString &mimeFormat = QString());
+    QJSValue mapFormat(const QJSValue &format, const QJSValue &transform, const QJSValue &targetFormat = QJSValue());
+    QJSValue removeDuplicates(const QJSValue &format = QJSValue());
+
 private:
     int m_id = -1;
     QString m_tabName;
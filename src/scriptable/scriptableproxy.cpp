@@ -12,10 +12,12 @@
 #include "common/contenttype.h"
 #include "common/display.h"
 #include "common/log.h"
+#include "common/metrics.h"
 #include "common/mimetypes.h"
 #include "common/settings.h"
 #include "common/sleeptimer.h"
 #include "common/textdata.h"
+#include "common/trace.h"
 #include "gui/clipboardbrowser.h"
 #include "gui/filedialog.h"
 #include "gui/iconfactory.h"
@@ -27,6 +29,7 @@
 #include "gui/tabicons.h"
 #include "gui/traymenu.h"
 #include "gui/windowgeometryguard.h"
+#include "item/itemsort.h"
 #include "item/serialize.h"
 #include "platform/platformnativeinterface.h"
 #include "platform/platformwindow.h"
@@ -59,7 +62,9 @@
 #include <QPen>
 #include <QPixmap>
 #include <QPushButton>
+#include <QRegularExpression>
 #include <QScreen>
+#include <QSet>
 #include <QShortcut>
 #include <QSpinBox>
 #include <QStyleFactory>
@@ -70,6 +75,7 @@
 #   include <QTest>
 #endif
 
+#include <algorithm>
 #include <type_traits>
 
 namespace {
@@ -126,6 +132,51 @@ void selectionRemoveInvalid(QList<QPersistentModelIndex> *indexes)
         });
 }
 
+bool selectionMatches(const QVariantMap &dataMap, const QVariant &maybeRe, const QString &mimeFormat)
+{
+    const QRegularExpression re = maybeRe.toRegularExpression();
+    if ( mimeFormat.isEmpty() )
+        return maybeRe.isValid() && getTextData(dataMap).contains(re);
+
+    return dataMap.contains(mimeFormat) == maybeRe.isValid()
+        && getTextData(dataMap, mimeFormat).contains(re);
+}
+
+qint64 selectionDataSize(const QVariantMap &dataMap, const QString &mimeFormat)
+{
+    if ( !mimeFormat.isEmpty() )
+        return dataMap.contains(mimeFormat) ? dataMap[mimeFormat].toByteArray().size() : -1;
+
+    qint64 size = 0;
+    for (const auto &value : dataMap)
+        size += value.toByteArray().size();
+    return size;
+}
+
+bool transformFormatData(const QString &transform, QByteArray *bytes)
+{
+    if ( transform == QLatin1String("lower") )
+        *bytes = getTextData(*bytes).toLower().toUtf8();
+    else if ( transform == QLatin1String("upper") )
+        *bytes = getTextData(*bytes).toUpper().toUtf8();
+    else if ( transform == QLatin1String("trimmed") )
+        *bytes = getTextData(*bytes).trimmed().toUtf8();
+    else if ( transform == QLatin1String("simplified") )
+        *bytes = getTextData(*bytes).simplified().toUtf8();
+    else if ( transform == QLatin1String("toBase64") )
+        *bytes = bytes->toBase64();
+    else if ( transform == QLatin1String("fromBase64") )
+        *bytes = QByteArray::fromBase64(*bytes);
+    else if ( transform == QLatin1String("toHex") )
+        *bytes = bytes->toHex();
+    else if ( transform == QLatin1String("fromHex") )
+        *bytes = QByteArray::fromHex(*bytes);
+    else
+        return false;
+
+    return true;
+}
+
 } // namespace
 
 #define BROWSER(tabName, call) \
@@ -165,6 +216,7 @@ void selectionRemoveInvalid(QList<QPersistentModelIndex> *indexes)
     using Result = decltype(FUNCTION ARGUMENTS); \
     CHECK_STREAM_OPERATORS(STR(#FUNCTION #ARGUMENTS)); \
     if (!m_wnd) { \
+        COPYQ_TRACE("ScriptableProxy::" STR(#FUNCTION)); \
         const auto functionCallId = ++m_lastFunctionCallId; \
         INVOKE_(FUNCTION, ARGUMENTS, functionCallId); \
         const auto result = waitForFunctionCallFinished(functionCallId); \
@@ -174,6 +226,7 @@ void selectionRemoveInvalid(QList<QPersistentModelIndex> *indexes)
 
 #define INVOKE2(FUNCTION, ARGUMENTS) do { \
     if (!m_wnd) { \
+        COPYQ_TRACE("ScriptableProxy::" STR(#FUNCTION)); \
         const auto functionCallId = ++m_lastFunctionCallId; \
         INVOKE_(FUNCTION, ARGUMENTS, functionCallId); \
         waitForFunctionCallFinished(functionCallId); \
@@ -844,6 +897,7 @@ ScriptableProxy::ScriptableProxy(MainWindow *mainWindow, QObject *parent)
     connect( this, &ScriptableProxy::clientDisconnected,
              this, [this]() {
                  m_disconnected = true;
+                 endBatches();
                  emit abortEvaluation();
              } );
 
@@ -854,6 +908,11 @@ ScriptableProxy::ScriptableProxy(MainWindow *mainWindow, QObject *parent)
 #endif
 }
 
+ScriptableProxy::~ScriptableProxy()
+{
+    endBatches();
+}
+
 void ScriptableProxy::callFunction(const QByteArray &serializedFunctionCall)
 {
     if (m_shouldBeDeleted)
@@ -926,6 +985,12 @@ QByteArray ScriptableProxy::callFunctionHelper(const QByteArray &serializedFunct
         }
     }
 
+    COPYQ_TRACE_DETAIL("ScriptableProxy::callFunction", slotName);
+
+    // Items added in a batch must be in tabs before anything else accesses them.
+    if ( m_wnd && !slotName.startsWith("browserInsert(") )
+        m_wnd->flushPendingItems();
+
     const auto slotIndex = metaObject()->indexOfSlot(slotName);
     if (slotIndex == -1) {
         log("Failed to find scriptable proxy slot: " + slotName, LogError);
@@ -1530,6 +1595,21 @@ QString ScriptableProxy::browserInsert(const QString &tabName, int row, const Va
     if ( !c->allocateSpaceForNewItems(items.items.size()) )
         return QLatin1String("Tab is full (cannot remove any items)");
 
+    // Insert all items at once, unless some need to be expanded.
+    const bool hasSerializedItems = std::any_of(
+        items.items.begin(), items.items.end(),
+        [](const QVariantMap &item) { return item.contains(mimeItems); });
+    if (!hasSerializedItems) {
+        QList<QVariantMap> dataList;
+        dataList.reserve( items.items.size() );
+        for (auto it = items.items.rbegin(); it != items.items.rend(); ++it)
+            dataList.append(*it);
+        if ( !c->addItemsInBatch(dataList, row) )
+            return QLatin1String("Failed to new add items");
+        return QString();
+    }
+
+    c->flushPendingItems();
     for (const auto &item : items.items) {
         if ( !c->add(item, row) )
             return QLatin1String("Failed to new add items");
@@ -1538,6 +1618,38 @@ QString ScriptableProxy::browserInsert(const QString &tabName, int row, const Va
     return QString();
 }
 
+void ScriptableProxy::browserBeginBatch(const QString &tabName)
+{
+    INVOKE2(browserBeginBatch, (tabName));
+
+    ClipboardBrowser *c = fetchBrowser(tabName);
+    if (!c)
+        return;
+
+    c->beginBatch();
+    m_batchBrowsers.append(c);
+}
+
+void ScriptableProxy::browserEndBatch(const QString &tabName)
+{
+    INVOKE2(browserEndBatch, (tabName));
+
+    ClipboardBrowser *c = fetchBrowser(tabName);
+    if ( !c || !m_batchBrowsers.removeOne(c) )
+        return;
+
+    c->endBatch();
+}
+
+void ScriptableProxy::endBatches()
+{
+    for (const auto &c : m_batchBrowsers) {
+        if (c)
+            c->endBatch();
+    }
+    m_batchBrowsers.clear();
+}
+
 QString ScriptableProxy::browserChange(const QString &tabName, int row, const VariantMapList &items)
 {
     INVOKE(browserChange, (tabName, row, items));
@@ -1808,7 +1920,6 @@ void ScriptableProxy::selectionSelect(int id, const QVariant &maybeRe, const QSt
     if (!selection.browser)
         return;
 
-    const QRegularExpression re = maybeRe.toRegularExpression();
     QList<QPersistentModelIndex> indexes;
     for (int row = 0; row < selection.browser->length(); ++row) {
         const auto index = selection.browser->index(row);
@@ -1816,17 +1927,8 @@ void ScriptableProxy::selectionSelect(int id, const QVariant &maybeRe, const QSt
             continue;
 
         const QVariantMap dataMap = index.data(contentType::data).toMap();
-        if ( mimeFormat.isEmpty() ) {
-            if ( !maybeRe.isValid() )
-                continue;
-            const QString text = getTextData(dataMap);
-            if ( text.contains(re) )
-                indexes.append(index);
-        } else if ( dataMap.contains(mimeFormat) == maybeRe.isValid() ) {
-            const QString text = getTextData(dataMap, mimeFormat);
-            if ( text.contains(re) )
-                indexes.append(index);
-        }
+        if ( selectionMatches(dataMap, maybeRe, mimeFormat) )
+            indexes.append(index);
     }
     selection.indexes.append(indexes);
     m_selections[id] = selection;
@@ -2016,6 +2118,117 @@ void ScriptableProxy::selectionSort(int id, const QVector<int> &indexes)
         selection.browser->sortItems(sorted);
 }
 
+void ScriptableProxy::selectionSortBy(int id, const QString &mimeFormat, const QVariant &maybeRe)
+{
+    INVOKE2(selectionSortBy, (id, mimeFormat, maybeRe));
+
+    auto selection = m_selections.value(id);
+    selectionRemoveInvalid(&selection.indexes);
+    if ( selection.indexes.isEmpty() )
+        return;
+
+    ItemSorter sorter(
+        selection.indexes, ItemSortKey::Format, mimeFormat, maybeRe.toRegularExpression() );
+    sorter.sort();
+    const QList<QPersistentModelIndex> sorted = sorter.sorted();
+
+    selection.browser->sortItems(sorted);
+}
+
+void ScriptableProxy::selectionFilter(int id, const QVariant &maybeRe, const QString &mimeFormat)
+{
+    INVOKE2(selectionFilter, (id, maybeRe, mimeFormat));
+    auto selection = m_selections.take(id);
+    if (!selection.browser)
+        return;
+
+    selectionRemoveIf(
+        &selection.indexes,
+        [&](const QPersistentModelIndex &index){
+            return !index.isValid()
+                || !selectionMatches(index.data(contentType::data).toMap(), maybeRe, mimeFormat);
+        });
+    m_selections[id] = selection;
+}
+
+void ScriptableProxy::selectionFilterSize(int id, qint64 minSize, qint64 maxSize, const QString &mimeFormat)
+{
+    INVOKE2(selectionFilterSize, (id, minSize, maxSize, mimeFormat));
+    auto selection = m_selections.take(id);
+    if (!selection.browser)
+        return;
+
+    selectionRemoveIf(
+        &selection.indexes,
+        [&](const QPersistentModelIndex &index){
+            if ( !index.isValid() )
+                return true;
+            const qint64 size = selectionDataSize(index.data(contentType::data).toMap(), mimeFormat);
+            return size < minSize || (maxSize >= 0 && size > maxSize);
+        });
+    m_selections[id] = selection;
+}
+
+bool ScriptableProxy::selectionMapFormat(
+        int id, const QString &mime, const QString &transform, const QString &targetMime)
+{
+    INVOKE(selectionMapFormat, (id, mime, transform, targetMime));
+
+    QByteArray testBytes;
+    if ( !transformFormatData(transform, &testBytes) )
+        return false;
+
+    const auto selection = m_selections.value(id);
+    if (!selection.browser)
+        return true;
+
+    const QString target = targetMime.isEmpty() ? mime : targetMime;
+    for (const auto &index : selection.indexes) {
+        if ( !index.isValid() )
+            continue;
+
+        QVariantMap data = index.data(contentType::data).toMap();
+        const auto it = data.constFind(mime);
+        if ( it == data.constEnd() )
+            continue;
+
+        QByteArray bytes = it.value().toByteArray();
+        transformFormatData(transform, &bytes);
+        data[target] = bytes;
+        selection.browser->model()->setData(index, data, contentType::data);
+    }
+
+    return true;
+}
+
+void ScriptableProxy::selectionRemoveDuplicates(int id, const QString &mimeFormat)
+{
+    INVOKE2(selectionRemoveDuplicates, (id, mimeFormat));
+    auto selection = m_selections.take(id);
+    if (!selection.browser)
+        return;
+    selectionRemoveInvalid(&selection.indexes);
+
+    QSet<QByteArray> seen;
+    QModelIndexList duplicates;
+    for (const auto &index : selection.indexes) {
+        const QVariantMap dataMap = index.data(contentType::data).toMap();
+        const QByteArray key = mimeFormat.isEmpty()
+            ? getTextData(dataMap).toUtf8()
+            : dataMap.value(mimeFormat).toByteArray();
+        if ( seen.contains(key) )
+            duplicates.append(index);
+        else
+            seen.insert(key);
+    }
+
+    if ( !duplicates.isEmpty() )
+        selection.browser->removeIndexes(duplicates);
+
+    selectionRemoveInvalid(&selection.indexes);
+    m_selections[id] = selection;
+}
+
 #ifdef HAS_TESTS
 void ScriptableProxy::sendKeys(const QString &expectedWidgetName, const QString &keys, int delay)
 {
@@ -2074,6 +2287,26 @@ void ScriptableProxy::serverLog(const QString &text)
     log(text, LogAlways);
 }
 
+void ScriptableProxy::traceStart()
+{
+    INVOKE2(traceStart, ());
+    startTracing();
+}
+
+QString ScriptableProxy::traceStop(const QString &fileName)
+{
+    INVOKE(traceStop, (fileName));
+    QString error;
+    stopTracing(fileName, &error);
+    return error;
+}
+
+QByteArray ScriptableProxy::metrics()
+{
+    INVOKE(metrics, ());
+    return metricsToJson();
+}
+
 QString ScriptableProxy::currentWindowTitle()
 {
     INVOKE(currentWindowTitle, ());
@@ -2410,6 +2643,7 @@ bool ScriptableProxy::setIconTagColor(const QString &colorName)
 void ScriptableProxy::setClipboardData(const QVariantMap &data)
 {
     INVOKE2(setClipboardData, (data));
+    addMetricCount("clipboard_events");
     m_wnd->setClipboardData(data);
 }
 
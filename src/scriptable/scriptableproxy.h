@@ -13,6 +13,7 @@
 #include <QObject>
 #include <QPersistentModelIndex>
 #include <QPoint>
+#include <QPointer>
 #include <QRect>
 #include <QVariant>
 #include <QVector>
@@ -77,6 +78,7 @@ class ScriptableProxy final : public QObject
 
 public:
     explicit ScriptableProxy(MainWindow* mainWindow, QObject *parent = nullptr);
+    ~ScriptableProxy();
 
     void callFunction(const QByteArray &serializedFunctionCall);
 
@@ -166,6 +168,8 @@ public slots:
     bool browserOpenEditor(const QString &tabName, const QByteArray &arg1, bool changeClipboard);
 
     QString browserInsert(const QString &tabName, int row, const VariantMapList &items);
+    void browserBeginBatch(const QString &tabName);
+    void browserEndBatch(const QString &tabName);
     QString browserChange(const QString &tabName, int row, const VariantMapList &items);
 
     QByteArray browserItemData(const QString &tabName, int arg1, const QString &arg2);
@@ -208,6 +212,11 @@ public slots:
     void selectionSetItemsFormat(int id, const QString &mime, const QVariant &value);
     void selectionMove(int id, int row);
     void selectionSort(int id, const QVector<int> &indexes);
+    void selectionSortBy(int id, const QString &mimeFormat, const QVariant &maybeRe);
+    void selectionFilter(int id, const QVariant &maybeRe, const QString &mimeFormat);
+    void selectionFilterSize(int id, qint64 minSize, qint64 maxSize, const QString &mimeFormat);
+    bool selectionMapFormat(int id, const QString &mime, const QString &transform, const QString &targetMime);
+    void selectionRemoveDuplicates(int id, const QString &mimeFormat);
 
 #ifdef HAS_TESTS
     void sendKeys(const QString &expectedWidgetName, const QString &keys, int delay);
@@ -218,6 +227,11 @@ public slots:
 
     void serverLog(const QString &text);
 
+    void traceStart();
+    QString traceStop(const QString &fileName);
+
+    QByteArray metrics();
+
     QString currentWindowTitle();
 
     int inputDialog(const NamedValueList &values);
@@ -293,6 +307,8 @@ private:
 
     QVariant waitForFunctionCallFinished(int functionId);
 
+    void endBatches();
+
     QByteArray callFunctionHelper(const QByteArray &serializedFunctionCall);
 
 #ifdef HAS_TESTS
@@ -314,6 +330,9 @@ private:
     QMap<int, ItemSelection> m_selections;
 
     bool m_disconnected = false;
+
+    /// Browsers with batch started by the client (ended when client disconnects).
+    QList<QPointer<ClipboardBrowser>> m_batchBrowsers;
 };
 
 QString pluginsPath();
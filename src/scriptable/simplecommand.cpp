@@ -0,0 +1,287 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "simplecommand.h"
+
+#include "common/clipboardmode.h"
+#include "common/command.h"
+#include "common/commandstatus.h"
+#include "common/commandstore.h"
+#include "common/log.h"
+#include "common/mimetypes.h"
+#include "common/textdata.h"
+#include "scriptable/scriptableproxy.h"
+
+#include <QFile>
+#include <QRegularExpression>
+
+namespace {
+
+bool toRow(const QString &arg, int *row)
+{
+    bool ok;
+    *row = arg.toInt(&ok);
+    return ok;
+}
+
+bool areRows(const QStringList &args)
+{
+    int row;
+    for (const auto &arg : args) {
+        if ( !toRow(arg, &row) )
+            return false;
+    }
+    return true;
+}
+
+/// Returns true if arguments for "write" are "[ROW] TEXT" or "[ROW] MIME DATA...".
+bool areWriteArguments(const QStringList &args)
+{
+    int row;
+    const int begin = !args.isEmpty() && toRow(args[0], &row) ? 1 : 0;
+    const int count = args.size() - begin;
+    if (count == 1)
+        return true;
+
+    if (count == 0 || count % 2 != 0)
+        return false;
+
+    // Serialized items need to be deserialized in script.
+    for (int i = begin; i < args.size(); i += 2) {
+        if (args[i] == mimeItems)
+            return false;
+    }
+
+    return true;
+}
+
+/// Returns true if a script command could override any of the functions.
+bool canBeOverridden(const QStringList &functionNames)
+{
+    Commands scriptCommands;
+    if ( !loadScriptCommandsCache(&scriptCommands) )
+        return true;
+
+    if ( scriptCommands.isEmpty() )
+        return false;
+
+    const QRegularExpression re(
+        QStringLiteral("\\b(%1)\\b").arg(functionNames.join('|')) );
+    for (const auto &command : scriptCommands) {
+        if ( command.cmd.contains(re) )
+            return true;
+    }
+
+    return false;
+}
+
+void printOutput(FILE *stream, const QByteArray &output)
+{
+    if ( output.isEmpty() || !canUseStandardOutput() )
+        return;
+
+    QFile f;
+    f.open(stream, QIODevice::WriteOnly);
+    f.write(output);
+}
+
+} // namespace
+
+QString parseCommandLineArgument(const QString &arg)
+{
+    QString result;
+    bool escape = false;
+
+    for (const auto &c : arg) {
+        if (escape) {
+            escape = false;
+
+            if (c == 'n')
+                result.append('\n');
+            else if (c == 't')
+                result.append('\t');
+            else if (c == '\\')
+                result.append('\\');
+            else
+                result.append(c);
+        } else if (c == '\\') {
+            escape = true;
+        } else {
+            result.append(c);
+        }
+    }
+
+    return result;
+}
+
+SimpleCommand::SimpleCommand(const QStringList &arguments)
+{
+    // Commands run from actions can depend on action data (e.g. selected tab).
+    if ( qEnvironmentVariableIsSet("COPYQ_ACTION_ID") )
+        return;
+
+    QStringList args;
+    args.reserve( arguments.size() );
+    for (const auto &arg : arguments) {
+        if ( arg == QLatin1String("-") || arg == QLatin1String("--") || arg == QLatin1String("-e") )
+            return;
+        args.append( parseCommandLineArgument(arg) );
+    }
+
+    QStringList functionNames;
+    int i = 0;
+    while ( i + 2 < args.size() && args[i] == QLatin1String("tab") ) {
+        m_tabName = args[i + 1];
+        functionNames = QStringList{QStringLiteral("tab")};
+        i += 2;
+    }
+
+    if ( i >= args.size() )
+        return;
+
+    const QString &name = args[i];
+    const QStringList commandArgs = args.mid(i + 1);
+    const Type type = commandType(name, commandArgs);
+    if (type == Type::Invalid)
+        return;
+
+    functionNames.append(name);
+    if ( canBeOverridden(functionNames) )
+        return;
+
+    m_type = type;
+    m_args = commandArgs;
+}
+
+int SimpleCommand::execute(ScriptableProxy *proxy) const
+{
+    QByteArray output;
+    QByteArray errorOutput;
+    const int exitCode = execute(proxy, &output, &errorOutput);
+    printOutput(stdout, output);
+    printOutput(stderr, errorOutput);
+    return exitCode;
+}
+
+int SimpleCommand::execute(ScriptableProxy *proxy, QByteArray *output, QByteArray *errorOutput) const
+{
+    QString error;
+
+    switch (m_type) {
+    case Type::Invalid:
+        Q_ASSERT(false);
+        return CommandError;
+
+    case Type::Tabs:
+        for ( const auto &tabName : proxy->tabs() )
+            output->append( tabName.toUtf8() + '\n' );
+        break;
+
+    case Type::Read: {
+        QString mime(mimeText);
+        bool used = false;
+        for (const auto &arg : m_args) {
+            int row;
+            if ( toRow(arg, &row) ) {
+                if (used)
+                    output->append('\n');
+                used = true;
+                output->append( row >= 0 ? proxy->browserItemData(m_tabName, row, mime)
+                                         : proxy->getClipboardData(mime, ClipboardMode::Clipboard) );
+            } else {
+                mime = arg;
+            }
+        }
+
+        if (!used)
+            output->append( proxy->getClipboardData(mime, ClipboardMode::Clipboard) );
+        break;
+    }
+
+    case Type::Add: {
+        VariantMapList items;
+        items.items.reserve( m_args.size() );
+        for (const auto &arg : m_args)
+            items.items.append( createDataMap(mimeText, arg) );
+        error = proxy->browserInsert(m_tabName, 0, items);
+        break;
+    }
+
+    case Type::Write: {
+        int row;
+        int begin = 1;
+        if ( !toRow(m_args[0], &row) ) {
+            row = 0;
+            begin = 0;
+        }
+
+        QVariantMap data;
+        if (m_args.size() - begin == 1) {
+            setTextData( &data, m_args[begin] );
+        } else {
+            for (int i = begin; i < m_args.size(); i += 2)
+                data.insert( m_args[i], m_args[i + 1].toUtf8() );
+        }
+        VariantMapList items;
+        items.items.append(data);
+        error = proxy->browserInsert(m_tabName, row, items);
+        break;
+    }
+
+    case Type::Select: {
+        int row;
+        toRow(m_args[0], &row);
+        proxy->browserMoveToClipboard(m_tabName, row);
+        break;
+    }
+
+    case Type::Length:
+        output->append( QByteArray::number(proxy->browserLength(m_tabName)) + '\n' );
+        break;
+
+    case Type::Remove: {
+        QVector<int> rows;
+        for (const auto &arg : m_args) {
+            int row;
+            toRow(arg, &row);
+            rows.append(row);
+        }
+        if ( rows.isEmpty() )
+            rows.append(0);
+        error = proxy->browserRemoveRows(m_tabName, rows);
+        break;
+    }
+    }
+
+    if ( !error.isEmpty() ) {
+        errorOutput->append( QStringLiteral("ScriptError: %1\n").arg(error).toUtf8() );
+        return CommandException;
+    }
+
+    return CommandFinished;
+}
+
+SimpleCommand::Type SimpleCommand::commandType(const QString &name, const QStringList &args)
+{
+    if ( name == QLatin1String("tab") )
+        return args.isEmpty() ? Type::Tabs : Type::Invalid;
+
+    if ( name == QLatin1String("read") )
+        return Type::Read;
+
+    if ( name == QLatin1String("add") )
+        return args.isEmpty() ? Type::Invalid : Type::Add;
+
+    if ( name == QLatin1String("write") )
+        return areWriteArguments(args) ? Type::Write : Type::Invalid;
+
+    if ( name == QLatin1String("select") )
+        return args.size() == 1 && areRows(args) ? Type::Select : Type::Invalid;
+
+    if ( name == QLatin1String("size") || name == QLatin1String("count") || name == QLatin1String("length") )
+        return args.isEmpty() ? Type::Length : Type::Invalid;
+
+    if ( name == QLatin1String("remove") )
+        return areRows(args) ? Type::Remove : Type::Invalid;
+
+    return Type::Invalid;
+}
@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SIMPLECOMMAND_H
+#define SIMPLECOMMAND_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+class ScriptableProxy;
+
+/// Unescapes "\n", "\t" and "\\" in a command line argument.
+QString parseCommandLineArgument(const QString &arg);
+
+/**
+ * Command line command which can run without script engine.
+ *
+ * Supports only commands which just pass arguments to server and print the
+ * result, optionally prefixed with "tab NAME": read, add, write, select,
+ * size/count/length, remove and tab (listing tabs).
+ *
+ * Anything else, including special arguments ("-", "--", "-e"), commands
+ * run from actions and commands possibly overridden by script commands, is
+ * invalid and must be evaluated by Scriptable.
+ */
+class SimpleCommand final {
+public:
+    explicit SimpleCommand(const QStringList &arguments);
+
+    bool isValid() const { return m_type != Type::Invalid; }
+
+    /// Runs the command, prints the result and returns exit code.
+    int execute(ScriptableProxy *proxy) const;
+
+    /// Runs the command, appends the result to buffers and returns exit code.
+    int execute(ScriptableProxy *proxy, QByteArray *output, QByteArray *errorOutput) const;
+
+private:
+    enum class Type {
+        Invalid,
+        Tabs,
+        Read,
+        Add,
+        Write,
+        Select,
+        Length,
+        Remove,
+    };
+
+    static Type commandType(const QString &name, const QStringList &args);
+
+    Type m_type = Type::Invalid;
+    QString m_tabName;
+    QStringList m_args;
+};
+
+#endif // SIMPLECOMMAND_H
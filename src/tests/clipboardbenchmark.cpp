@@ -0,0 +1,468 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "clipboardbenchmark.h"
+
+#include "common/appconfig.h"
+#include "common/clipboardmode.h"
+#include "common/command.h"
+#include "common/commandstore.h"
+#include "common/mimetypes.h"
+#include "common/settings.h"
+#include "common/textdata.h"
+#include "item/itemstore.h"
+#include "platform/platformclipboard.h"
+#include "platform/platformnativeinterface.h"
+
+#include <QBuffer>
+#include <QColor>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QImage>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QVector>
+
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#   include <unistd.h>
+#endif
+
+namespace {
+
+const QLatin1String benchmarkTabName("BENCHMARK");
+const QByteArray benchmarkIdPrefix("copyq-benchmark-");
+
+const QLatin1String addedLogEnv("COPYQ_BENCHMARK_ADDED_LOG");
+
+// Appends ID of each new item with current time (ms since epoch) to a log file
+// right after the item is stored.
+const QLatin1String addedLogScript(R"(
+var onClipboardChanged_ = onClipboardChanged;
+global.onClipboardChanged = function() {
+    onClipboardChanged_();
+    var f = new File(env('COPYQ_BENCHMARK_ADDED_LOG'));
+    if (f.openAppend()) {
+        f.write(str(data(mimeText)).split(' ')[0] + ' ' + Date.now() + '\n');
+        f.close();
+    }
+}
+)");
+
+// Stop waiting for items if nothing happens for this interval after all
+// clipboard changes were set.
+const int idleTimeoutMs = 5000;
+
+struct PayloadType {
+    QString name;
+    int weight;
+};
+
+struct BenchmarkOptions {
+    int count = 500;
+    int rate = 20;
+    int textSize = 100;
+    int imageSize = 256;
+    QVector<PayloadType> mix{{"text", 80}, {"html", 15}, {"image", 5}};
+    QString jsonFileName;
+};
+
+struct ProcessUsage {
+    qint64 cpuMs = -1;
+    qint64 rssKiB = -1;
+    qint64 peakRssKiB = -1;
+};
+
+struct ItemTimes {
+    qint64 set = -1;
+    qint64 added = -1;
+    qint64 saved = -1;
+};
+
+void printOutput(const QByteArray &text)
+{
+    QFile f;
+    f.open(stdout, QIODevice::WriteOnly);
+    f.write(text);
+}
+
+void printError(const QString &text)
+{
+    QFile f;
+    f.open(stderr, QIODevice::WriteOnly);
+    f.write(text.toUtf8() + '\n');
+}
+
+bool parseMix(const QString &value, QVector<PayloadType> *mix)
+{
+    mix->clear();
+    for ( const auto &part : value.split(',') ) {
+        const auto nameWeight = part.split(':');
+        bool ok;
+        const int weight = nameWeight.value(1, "1").toInt(&ok);
+        const auto name = nameWeight.value(0);
+        if ( !ok || weight < 0 || !QStringList({"text", "html", "image"}).contains(name) )
+            return false;
+        mix->append({name, weight});
+    }
+
+    return std::any_of(mix->begin(), mix->end(), [](const PayloadType &type){
+        return type.weight > 0;
+    });
+}
+
+bool parseOptions(const QStringList &arguments, BenchmarkOptions *options)
+{
+    for (const auto &arg : arguments) {
+        const int i = arg.indexOf('=');
+        const QString name = arg.left(i);
+        const QString value = i == -1 ? QString() : arg.mid(i + 1);
+        bool ok = true;
+        if (name == "--count")
+            options->count = value.toInt(&ok);
+        else if (name == "--rate")
+            options->rate = value.toInt(&ok);
+        else if (name == "--text-size")
+            options->textSize = value.toInt(&ok);
+        else if (name == "--image-size")
+            options->imageSize = value.toInt(&ok);
+        else if (name == "--mix")
+            ok = parseMix(value, &options->mix);
+        else if (name == "--json")
+            options->jsonFileName = value;
+        else
+            ok = false;
+
+        if (!ok) {
+            printError( QStringLiteral("Invalid benchmark argument: %1").arg(arg) );
+            return false;
+        }
+    }
+
+    if (options->count <= 0 || options->count > Config::maxItems) {
+        printError( QStringLiteral("Item count must be between 1 and %1").arg(Config::maxItems) );
+        return false;
+    }
+
+    if (options->rate <= 0) {
+        printError( QStringLiteral("Rate must be positive") );
+        return false;
+    }
+
+    return true;
+}
+
+ProcessUsage processUsage(qint64 pid)
+{
+    ProcessUsage usage;
+#ifdef Q_OS_LINUX
+    QFile statFile( QStringLiteral("/proc/%1/stat").arg(pid) );
+    if ( statFile.open(QIODevice::ReadOnly) ) {
+        const QByteArray stat = statFile.readAll();
+        // Skip PID and command name (which can contain spaces).
+        const QList<QByteArray> fields = stat.mid(stat.lastIndexOf(')') + 2).split(' ');
+        // Fields "utime" and "stime" (14 and 15 in proc(5) numbering).
+        const long ticksPerSecond = sysconf(_SC_CLK_TCK);
+        if ( fields.size() > 12 && ticksPerSecond > 0 )
+            usage.cpuMs = (fields[11].toLongLong() + fields[12].toLongLong()) * 1000 / ticksPerSecond;
+    }
+
+    QFile statusFile( QStringLiteral("/proc/%1/status").arg(pid) );
+    if ( statusFile.open(QIODevice::ReadOnly) ) {
+        for ( const auto &line : statusFile.readAll().split('\n') ) {
+            const auto fields = line.simplified().split(' ');
+            if ( fields.value(0) == "VmRSS:" )
+                usage.rssKiB = fields.value(1).toLongLong();
+            else if ( fields.value(0) == "VmHWM:" )
+                usage.peakRssKiB = fields.value(1).toLongLong();
+        }
+    }
+#else
+    Q_UNUSED(pid)
+#endif
+    return usage;
+}
+
+QByteArray createImage(int id, int size)
+{
+    QImage image(size, size, QImage::Format_RGB32);
+    image.fill( QColor::fromHsv(id % 360, 200, 200) );
+    QByteArray bytes;
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    return bytes;
+}
+
+QVariantMap createPayload(int id, const QString &type, const BenchmarkOptions &options)
+{
+    QByteArray text = benchmarkIdPrefix + QByteArray::number(id) + ' ';
+    text.append( QByteArray(qMax(0, options.textSize - text.size()), 'x') );
+
+    QVariantMap data = createDataMap(mimeText, text);
+    if (type == "html")
+        data.insert( mimeHtml, QByteArray("<p>" + text + "</p>") );
+    else if (type == "image")
+        data.insert( QStringLiteral("image/png"), createImage(id, options.imageSize) );
+
+    return data;
+}
+
+QString choosePayloadType(const QVector<PayloadType> &mix, QRandomGenerator *random)
+{
+    int totalWeight = 0;
+    for (const auto &type : mix)
+        totalWeight += type.weight;
+
+    int value = static_cast<int>( random->bounded(totalWeight) );
+    for (const auto &type : mix) {
+        if (value < type.weight)
+            return type.name;
+        value -= type.weight;
+    }
+
+    return mix.last().name;
+}
+
+double percentile(QVector<qint64> values, double p)
+{
+    if ( values.isEmpty() )
+        return -1;
+
+    std::sort(values.begin(), values.end());
+    const int i = qBound(0, static_cast<int>(p * (values.size() - 1) + 0.5), values.size() - 1);
+    return values[i];
+}
+
+QJsonObject latencyStats(const QVector<qint64> &latencies)
+{
+    return QJsonObject{
+        {"count", latencies.size()},
+        {"p50", percentile(latencies, 0.5)},
+        {"p99", percentile(latencies, 0.99)},
+        {"max", percentile(latencies, 1.0)},
+    };
+}
+
+QByteArray formatLatency(const char *label, const QJsonObject &stats)
+{
+    return QStringLiteral("%1: p50 %2 ms, p99 %3 ms, max %4 ms (%5 items)\n")
+        .arg(QLatin1String(label))
+        .arg(stats["p50"].toDouble())
+        .arg(stats["p99"].toDouble())
+        .arg(stats["max"].toDouble())
+        .arg(stats["count"].toInt())
+        .toUtf8();
+}
+
+void configureSession(const BenchmarkOptions &options)
+{
+    Settings settings;
+    settings.clear();
+
+    settings.beginGroup("Options");
+    settings.setValue( Config::clipboard_tab::name(), QString(benchmarkTabName) );
+    settings.setValue( Config::maxitems::name(), options.count );
+    settings.setValue( Config::close_on_unfocus::name(), false );
+    // Save tab as soon as possible to measure save latency.
+    settings.setValue( Config::save_delay_ms_on_item_added::name(), 0 );
+    settings.endGroup();
+
+    removeItems(benchmarkTabName);
+
+    Command command;
+    command.name = QStringLiteral("Benchmark: Log added items");
+    command.cmd = addedLogScript;
+    command.isScript = true;
+    saveCommands({command});
+}
+
+} // namespace
+
+int runClipboardBenchmark(const TestInterfacePtr &test, const QStringList &arguments)
+{
+    BenchmarkOptions options;
+    if ( !parseOptions(arguments, &options) )
+        return 2;
+
+    if ( test->isServerRunning() )
+        test->stopServer();
+
+    configureSession(options);
+
+    QTemporaryDir logDir;
+    const QString addedLogFileName = logDir.filePath("added.log");
+    QFile addedLog(addedLogFileName);
+    if ( !logDir.isValid() || !addedLog.open(QIODevice::ReadWrite) ) {
+        printError( QStringLiteral("Failed to create log file for added items") );
+        return 1;
+    }
+    test->setEnv(addedLogEnv, addedLogFileName);
+
+    const QByteArray startErrors = test->startServer();
+    if ( !startErrors.isEmpty() ) {
+        printError( QString::fromUtf8(startErrors) );
+        return 1;
+    }
+
+    const qint64 serverPid = test->serverProcessId();
+    auto clipboard = platformNativeInterface()->clipboard();
+
+    QHash<int, ItemTimes> items;
+    QVector<qint64> saveTimes;
+
+    QEventLoop loop;
+
+    QTimer idleTimer;
+    idleTimer.setSingleShot(true);
+    idleTimer.setInterval(idleTimeoutMs);
+    QObject::connect(&idleTimer, &QTimer::timeout, &loop, &QEventLoop::quit);
+
+    // Log file is appended by the script command after each item is stored.
+    QByteArray addedLogData;
+    QFileSystemWatcher addedLogWatcher;
+    addedLogWatcher.addPath(addedLogFileName);
+    QObject::connect(&addedLogWatcher, &QFileSystemWatcher::fileChanged, &loop, [&]() {
+        addedLogData.append( addedLog.readAll() );
+        const int end = addedLogData.lastIndexOf('\n');
+        if (end == -1)
+            return;
+
+        for ( const auto &line : addedLogData.left(end).split('\n') ) {
+            const auto fields = line.trimmed().split(' ');
+            if ( !fields.value(0).startsWith(benchmarkIdPrefix) )
+                continue;
+            const int id = fields[0].mid(benchmarkIdPrefix.size()).toInt();
+            auto it = items.find(id);
+            if ( it != items.end() && it->added == -1 )
+                it->added = fields.value(1).toLongLong();
+        }
+        addedLogData.remove(0, end + 1);
+
+        if ( idleTimer.isActive() )
+            idleTimer.start();
+    });
+
+    // Tab is saved using QSaveFile which renames temporary file to the tab file.
+    const QString tabFileName = itemFileName(benchmarkTabName);
+    QDateTime lastModified = QFileInfo(tabFileName).lastModified();
+    QFileSystemWatcher watcher;
+    watcher.addPath( QFileInfo(tabFileName).absolutePath() );
+    QObject::connect(&watcher, &QFileSystemWatcher::directoryChanged, &loop, [&]() {
+        const QDateTime modified = QFileInfo(tabFileName).lastModified();
+        if (modified != lastModified) {
+            lastModified = modified;
+            saveTimes.append( QDateTime::currentMSecsSinceEpoch() );
+        }
+    });
+
+    const ProcessUsage usageBefore = processUsage(serverPid);
+    const qint64 startTime = QDateTime::currentMSecsSinceEpoch();
+
+    QRandomGenerator random(42);
+    int nextId = 0;
+    QElapsedTimer rateTimer;
+    QTimer setClipboardTimer;
+    // With rates over 1000/s, multiple changes are set on each timeout to keep the rate.
+    setClipboardTimer.setInterval( qMax(1, 1000 / options.rate) );
+    QObject::connect(&setClipboardTimer, &QTimer::timeout, &loop, [&]() {
+        const qint64 due = qMin<qint64>(
+            options.count, rateTimer.nsecsElapsed() / 1000 * options.rate / 1000000 + 1);
+        while (nextId < due) {
+            const int id = nextId++;
+            const QString type = choosePayloadType(options.mix, &random);
+            const QVariantMap data = createPayload(id, type, options);
+            items[id].set = QDateTime::currentMSecsSinceEpoch();
+            clipboard->setData(ClipboardMode::Clipboard, data);
+        }
+
+        if (nextId >= options.count) {
+            setClipboardTimer.stop();
+            idleTimer.start();
+        }
+    });
+    rateTimer.start();
+    setClipboardTimer.start();
+
+    loop.exec();
+
+    const qint64 endTime = QDateTime::currentMSecsSinceEpoch();
+    const ProcessUsage usageAfter = processUsage(serverPid);
+
+    QVector<qint64> addLatencies;
+    QVector<qint64> saveLatencies;
+    qint64 lastAdded = startTime;
+    for (auto &times : items) {
+        if (times.added == -1)
+            continue;
+
+        addLatencies.append(times.added - times.set);
+        lastAdded = qMax(lastAdded, times.added);
+
+        const auto it = std::lower_bound(saveTimes.begin(), saveTimes.end(), times.added);
+        if ( it != saveTimes.end() ) {
+            times.saved = *it;
+            saveLatencies.append(times.saved - times.set);
+        }
+    }
+
+    const int droppedCount = options.count - addLatencies.size();
+    const qint64 elapsedMs = qMax<qint64>(1, lastAdded - startTime);
+    const double throughput = addLatencies.size() * 1000.0 / elapsedMs;
+    const double cpuPercent =
+        usageBefore.cpuMs >= 0 && usageAfter.cpuMs >= 0
+        ? (usageAfter.cpuMs - usageBefore.cpuMs) * 100.0 / qMax<qint64>(1, endTime - startTime)
+        : -1;
+
+    const auto addStats = latencyStats(addLatencies);
+    const auto saveStats = latencyStats(saveLatencies);
+
+    printOutput(
+        QStringLiteral("Clipboard changes set: %1 (rate %2/s), stored: %3, dropped: %4\n")
+        .arg(options.count).arg(options.rate).arg(addLatencies.size()).arg(droppedCount).toUtf8()
+        + formatLatency("Clipboard to item in tab", addStats)
+        + formatLatency("Clipboard to tab saved", saveStats)
+        + QStringLiteral("Throughput: %1 items/s\n").arg(throughput, 0, 'f', 1).toUtf8()
+        + QStringLiteral("Server CPU: %1 %, RSS: %2 KiB, peak RSS: %3 KiB\n")
+          .arg(cpuPercent, 0, 'f', 1).arg(usageAfter.rssKiB).arg(usageAfter.peakRssKiB).toUtf8()
+    );
+
+    if ( !options.jsonFileName.isEmpty() ) {
+        QJsonObject mix;
+        for (const auto &type : options.mix)
+            mix.insert(type.name, type.weight);
+
+        const QJsonObject root{
+            {"count", options.count},
+            {"rate", options.rate},
+            {"textSize", options.textSize},
+            {"imageSize", options.imageSize},
+            {"mix", mix},
+            {"stored", addLatencies.size()},
+            {"dropped", droppedCount},
+            {"addLatencyMs", addStats},
+            {"saveLatencyMs", saveStats},
+            {"throughputItemsPerSecond", throughput},
+            {"serverCpuPercent", cpuPercent},
+            {"serverRssKiB", usageAfter.rssKiB},
+            {"serverPeakRssKiB", usageAfter.peakRssKiB},
+        };
+
+        QFile jsonFile(options.jsonFileName);
+        if ( !jsonFile.open(QIODevice::WriteOnly) ) {
+            printError( QStringLiteral("Failed to write benchmark results: %1").arg(jsonFile.errorString()) );
+            return 1;
+        }
+        jsonFile.write( QJsonDocument(root).toJson() );
+    }
+
+    return addLatencies.isEmpty() ? 1 : 0;
+}
@@ -0,0 +1,25 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CLIPBOARDBENCHMARK_H
+#define CLIPBOARDBENCHMARK_H
+
+#include "tests/testinterface.h"
+
+class QStringList;
+
+/**
+ * Measure latency and throughput of storing clipboard changes.
+ *
+ * Starts test server, sets synthetic clipboard content at given rate and
+ * measures time until each item appears in clipboard tab and until the tab
+ * is saved. Also reports CPU time and memory used by the server process.
+ *
+ * Usage: copyq tests BENCHMARK [--count=N] [--rate=N] [--text-size=BYTES]
+ *                              [--image-size=PIXELS] [--mix=text:80,html:15,image:5]
+ *                              [--json=FILE]
+ *
+ * @return exit code
+ */
+int runClipboardBenchmark(const TestInterfacePtr &test, const QStringList &arguments);
+
+#endif // CLIPBOARDBENCHMARK_H
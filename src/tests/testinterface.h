@@ -39,6 +39,9 @@ public:
     /// Return true if GUI server is not running.
     virtual bool isServerRunning() = 0;
 
+    /// Return process ID of GUI server or -1 if it's not running.
+    virtual qint64 serverProcessId() = 0;
+
     /// Run client with given @a arguments and input and read outputs and return exit code.
     virtual int run(const QStringList &arguments, QByteArray *stdoutData = nullptr,
                     QByteArray *stderrData = nullptr, const QByteArray &in = QByteArray(),
@@ -3,6 +3,8 @@
 #include "tests.h"
 #include "test_utils.h"
 
+#include "tests/clipboardbenchmark.h"
+
 #include "common/action.h"
 #include "common/appconfig.h"
 #include "common/client_server.h"
@@ -16,6 +18,7 @@
 #include "common/textdata.h"
 #include "common/version.h"
 #include "item/itemfactory.h"
+#include "item/itemstore.h"
 #include "item/itemwidget.h"
 #include "item/serialize.h"
 #include "gui/tabicons.h"
@@ -28,6 +31,9 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QGuiApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QMap>
 #include <QMimeData>
 #include <QProcess>
@@ -338,6 +344,11 @@ public:
         return m_server != nullptr && m_server->state() == QProcess::Running;
     }
 
+    qint64 serverProcessId() override
+    {
+        return isServerRunning() ? m_server->processId() : -1;
+    }
+
     int run(const QStringList &arguments, QByteArray *stdoutData = nullptr,
             QByteArray *stderrData = nullptr, const QByteArray &in = QByteArray(),
             const QStringList &environment = QStringList()) override
@@ -1107,6 +1118,30 @@ void Tests::commandsAddRead()
     RUN("read" << "3", "A");
 }
 
+void Tests::commandsSessionPipe()
+{
+    const QByteArray input =
+        "add A\n"
+        "[\"add\", \"B\"]\n"
+        "\n"
+        "{\"id\": \"read\", \"args\": [\"read\", \"0\", \"1\"]}\n"
+        "{\"args\": [\"eval\", \"str(input()) + 1\"], \"input\": \"X\"}\n"
+        "size\n"
+        "[1]\n"
+        "[\"eval\", \"print(fromBase64('/wA='))\"]\n";
+
+    const QByteArray output =
+        R"({"errorOutput":"","exitCode":0,"id":1,"output":""})" "\n"
+        R"({"errorOutput":"","exitCode":0,"id":2,"output":""})" "\n"
+        R"({"errorOutput":"","exitCode":0,"id":"read","output":"B\nA"})" "\n"
+        R"({"errorOutput":"","exitCode":0,"id":5,"output":"X1\n"})" "\n"
+        R"({"errorOutput":"","exitCode":0,"id":6,"output":"2\n"})" "\n"
+        R"({"errorOutput":"Invalid request: expected array of string arguments\n","exitCode":2,"id":7,"output":""})" "\n"
+        R"({"errorOutput":"","exitCode":0,"id":8,"outputBase64":"/wA="})" "\n";
+
+    RUN_WITH_INPUT("--session-pipe", input, output);
+}
+
 void Tests::commandsWriteRead()
 {
     const QByteArray input("\x00\x01\x02\x03\x04", 5);
@@ -1453,6 +1488,11 @@ void Tests::commandExecute()
         "c = execute('copyq', 'read', 0, function(lines) { print(lines); });"
         "test(c, 'plain text', 0);"
         , "plain text");
+
+    RUN("eval" << script +
+        "c = execute('copyq', 'eval', '--', 'print(input().length)', null, 'ab', ByteArray(3000000), 'cd');"
+        "test(c, '3000004', 0);"
+        , "");
 }
 
 void Tests::commandSettings()
@@ -1953,6 +1993,51 @@ void Tests::commandServerLogAndLogs()
     QVERIFY( QString::fromUtf8(stdoutActual).contains(re) );
 }
 
+void Tests::commandMetrics()
+{
+    QByteArray stdoutActual;
+    QByteArray stderrActual;
+    QCOMPARE( run(Args("metrics"), &stdoutActual, &stderrActual), 0 );
+    QVERIFY2( testStderr(stderrActual), stderrActual );
+
+    const QJsonDocument metrics = QJsonDocument::fromJson(stdoutActual);
+    QVERIFY2( metrics.isObject(), stdoutActual );
+
+    const QJsonObject root = metrics.object();
+    QVERIFY( root.value("uptimeMs").toDouble() > 0 );
+    QVERIFY( root.value("gauges").isObject() );
+    QVERIFY( root.value("histograms").isObject() );
+
+    const QJsonObject counters = root.value("counters").toObject();
+    QVERIFY2( counters.value("ipc_bytes_received").toDouble() > 0, stdoutActual );
+    QVERIFY2( counters.value("ipc_messages_received").toDouble() > 0, stdoutActual );
+}
+
+void Tests::commandTraceStartStop()
+{
+    TemporaryFile tmp;
+    const auto fileName = tmp.fileName();
+
+    RUN("traceStart", "");
+    RUN("add" << "A", "");
+    RUN("traceStop" << fileName, "");
+
+    QFile file(fileName);
+    QVERIFY( file.open(QIODevice::ReadOnly) );
+    const QJsonDocument trace = QJsonDocument::fromJson(file.readAll());
+    QVERIFY( trace.isObject() );
+
+    QStringList names;
+    for ( const auto &event : trace.object().value("traceEvents").toArray() )
+        names.append( event.toObject().value("name").toString() );
+    QVERIFY2( names.contains("Scriptable::eval"), qPrintable(names.join(", ")) );
+    QVERIFY2( names.contains("ScriptableProxy::callFunction"), qPrintable(names.join(", ")) );
+    QVERIFY2( names.contains("process_name"), qPrintable(names.join(", ")) );
+
+    RUN_EXPECT_ERROR_WITH_STDERR(
+        "traceStop" << fileName, CommandException, "Tracing was not started");
+}
+
 void Tests::classByteArray()
 {
     RUN("ByteArray", "");
@@ -1983,6 +2068,20 @@ void Tests::classByteArray()
     RUN("ByteArray('a') + 'b'", "ab\n");
 }
 
+void Tests::classByteArrayArrayBuffer()
+{
+    RUN("str(new Uint8Array([65, 66, 67]))", "ABC\n");
+    RUN("str(new Uint8Array([65, 66, 67]).subarray(1))", "BC\n");
+    RUN("str(new Uint8Array([65, 66, 67]).buffer)", "ABC\n");
+    RUN("ByteArray(new Uint8Array([65, 66]).buffer)", "AB");
+
+    RUN("add(new Uint8Array([65, 66]).buffer); read(0)", "AB");
+    RUN("useArrayBuffer = true; read(0) instanceof ArrayBuffer", "true\n");
+    RUN("useArrayBuffer = true; new Uint8Array(read(0))[1]", "66\n");
+    RUN("useArrayBuffer = true; read(0)", "AB");
+    RUN("useArrayBuffer", "false\n");
+}
+
 void Tests::classFile()
 {
     RUN("var f = new File('/copyq_missing_file'); f.exists()", "false\n");
@@ -2322,6 +2421,38 @@ void Tests::classItemSelectionSort()
     RUN(args << "size", "5\n");
 }
 
+void Tests::classItemSelectionBulkOperations()
+{
+    const auto tab1 = testTab(1);
+    const Args args = Args("tab") << tab1 << "separator" << ",";
+    const QString outRows("ItemSelection(tab=\"" + tab1 + "\", rows=[%1])\n");
+    RUN("setCurrentTab" << tab1, "");
+
+    RUN(args << "add('b2','a3','c1','a3','bbb')", "");
+    RUN(args << "read(0,1,2,3,4)", "bbb,a3,c1,a3,b2");
+
+    RUN(args << "ItemSelection().selectAll().filter(/^a/).str()", outRows.arg("1,3"));
+    RUN(args << "ItemSelection().selectAll().filterSize(3).str()", outRows.arg("0"));
+    RUN(args << "ItemSelection().selectAll().filterSize(0, 2, mimeText).str()", outRows.arg("1..4"));
+
+    RUN(args << "ItemSelection().selectAll().removeDuplicates().str()", outRows.arg("0..3"));
+    RUN(args << "read(0,1,2,3)", "bbb,a3,c1,b2");
+
+    RUN(args << "ItemSelection().selectAll().sortBy(mimeText, /\\d/).str()", outRows.arg("0,3,1,2"));
+    RUN(args << "read(0,1,2,3)", "bbb,c1,b2,a3");
+
+    RUN(args << "ItemSelection().selectAll().sortBy().str()", outRows.arg("2,3,1,0"));
+    RUN(args << "read(0,1,2,3)", "a3,b2,bbb,c1");
+
+    RUN(args << "ItemSelection().select(/^b/).mapFormat(mimeText, 'upper').str()", outRows.arg("1,2"));
+    RUN(args << "read(0,1,2,3)", "a3,B2,BBB,c1");
+    RUN(args << "ItemSelection().selectAll().mapFormat(mimeText, 'toHex', 'test/hex'); read('test/hex', 0)", "6133");
+
+    RUN_EXPECT_ERROR_WITH_STDERR(
+        args << "ItemSelection().selectAll().mapFormat(mimeText, 'bad')",
+        CommandException, "Unknown transform: bad");
+}
+
 void Tests::classSettings()
 {
     TemporaryFile configFile;
@@ -2648,6 +2779,23 @@ void Tests::sortAndReverse()
     RUN(args << "testSelected", tab + " 1 0 1 2 3\n");
 }
 
+void Tests::sortAndReverseManyItems()
+{
+    const auto tab = testTab(1);
+    const Args args = Args("tab") << tab << "separator" << " ";
+    RUN("config" << "maxitems" << "10000", "10000\n");
+    RUN(args << "beginBatch(); for (var i = 0; i < 6000; ++i) add(('000' + i).slice(-4)); endBatch()", "");
+    RUN("setCurrentTab" << tab, "");
+
+    // Many items are sorted in background.
+    RUN("keys" << "CTRL+A" << "CTRL+SHIFT+S", "");
+    WAIT_ON_OUTPUT(args << "read" << "0" << "1" << "5999", "0000 0001 5999");
+
+    RUN("keys" << "CTRL+SHIFT+R", "");
+    WAIT_ON_OUTPUT(args << "read" << "0" << "1" << "5999", "5999 5998 0000");
+    RUN(args << "size", "6000\n");
+}
+
 void Tests::createTabDialog()
 {
     const auto tab1 = testTab(1);
@@ -2811,6 +2959,36 @@ void Tests::tabAdd()
     RUN(args << "read" << "0" << "1" << "2", "abc def ghi");
 }
 
+void Tests::tabKeepCorruptedPrefetched()
+{
+    const QString tab = testTab(1);
+    const Args args = Args("tab") << tab << "separator" << " ";
+
+    // Clipboard tab data are read in background on start.
+    RUN("config" << "clipboard_tab" << tab, tab + "\n");
+    RUN(args << "add" << "C" << "B" << "A", "");
+    TEST( m_test->stopServer() );
+
+    // Corrupt the last item.
+    QFile tabFile( itemFileName(tab) );
+    QVERIFY( tabFile.open(QIODevice::ReadWrite) );
+    QVERIFY( tabFile.resize(tabFile.size() - 1) );
+    tabFile.close();
+
+    TEST( m_test->startServer() );
+
+    // Load the tab asynchronously and keep the readable items.
+    RUN("action" << QString("copyq tab %1 read 99").arg(tab) << "", "");
+    RUN("keys" << "focus::QPushButton in :QMessageBox" << "ENTER", "");
+    WAIT_ON_OUTPUT(args << "read" << "0" << "1", "A B");
+
+    // Repaired tab data are saved, so the next start does not ask again.
+    TEST( m_test->stopServer() );
+    TEST( m_test->startServer() );
+    RUN(args << "size", "2\n");
+    RUN(args << "read" << "0" << "1", "A B");
+}
+
 void Tests::tabRemove()
 {
     const QString tab = testTab(1);
@@ -2862,6 +3040,18 @@ void Tests::action()
     RUN(argsAction << action.arg("read 0") << ",", "");
     WAIT_ON_OUTPUT(args << "size", "6\n");
     RUN(args << "read" << "0" << "1" << "2", "C\nB\nA");
+
+    // action with many output items added in batches
+    RUN("config" << "maxitems" << "5000", "5000\n");
+    RUN(argsAction << action.arg("eval 'for (var i = 0; i < 3000; ++i) print(i + \"ž,\")'") << ",", "");
+    WAIT_ON_OUTPUT(args << "size", "3006\n");
+    RUN(args << "read" << "0" << "1" << "2999", "2999ž\n2998ž\n0ž");
+
+    // action with long separators spanning output chunks
+    RUN("config" << "maxitems" << "6000", "6000\n");
+    RUN(argsAction << action.arg("eval 'var s = Array(201).join(\"=\"); for (var i = 0; i < 2000; ++i) print(i + s)'") << "={200}", "");
+    WAIT_ON_OUTPUT(args << "size", "5006\n");
+    RUN(args << "read" << "0" << "1" << "1999", "1999\n1998\n0");
 }
 
 void Tests::insertRemoveItems()
@@ -2883,6 +3073,31 @@ void Tests::insertRemoveItems()
     RUN(args << "read" << "0" << "1" << "2" << "3" << "4", "abc,ABC,ghi,,");
 }
 
+void Tests::insertRemoveItemsInBatch()
+{
+    const Args args = Args("tab") << testTab(1) << "separator" << ",";
+
+    RUN("config" << "maxitems" << "10000", "10000\n");
+    RUN(args << "beginBatch(); for (var i = 0; i < 10000; ++i) add(i); endBatch()", "");
+    RUN(args << "size", "10000\n");
+    RUN(args << "read" << "0" << "1" << "9999", "9999,9998,0");
+
+    RUN(args << "insert(1, 'a', 'b', 'c'); read(0, 1, 2, 3, 4)", "9999,c,b,a,9998");
+
+    // Batch is ended when script finishes.
+    RUN(args << "beginBatch(); remove(0, 1, 2)", "");
+    RUN(args << "read" << "0" << "1", "a,9998");
+    RUN(args << "add('x'); read(0)", "x");
+
+    // Consecutive additions are inserted at once.
+    const Args args2 = Args("tab") << testTab(2) << "separator" << ",";
+    RUN(args2 << "beginBatch(); add('A'); add('B'); insert(2, 'Z'); add('C'); insert(1, 'M'); add('D'); endBatch()", "");
+    RUN(args2 << "read(0, 1, 2, 3, 4, 5)", "D,C,M,B,A,Z");
+    RUN(args2 << "beginBatch(); add('E'); size()", "7\n");
+    RUN(args2 << "beginBatch(); add('F'); remove(1); read(0, 1)", "F,D");
+    RUN(args2 << "size", "7\n");
+}
+
 void Tests::renameTab()
 {
     const QString tab1 = testTab(1);
@@ -3098,6 +3313,39 @@ void Tests::externalEditor()
 #undef EDIT
 }
 
+void Tests::importTabArchiveContinue()
+{
+    const QString tab = testTab(1);
+    const Args args = Args("tab") << tab << "separator" << " ";
+
+    // Items are larger than a chunk in archive.
+    RUN(args << "for (var i = 0; i < 3; ++i) add(i + new Array(3 * 1024 * 1024).join('x'))", "");
+
+    TemporaryFile tmp;
+    RUN(args << "exporttab" << tmp.fileName(), "");
+    RUN("removetab" << tab, "");
+
+    // Remove end of archive to interrupt the import.
+    QFile file(tmp.fileName());
+    QVERIFY( file.open(QIODevice::ReadWrite) );
+    const QByteArray archive = file.readAll();
+    QVERIFY( file.resize(archive.size() - 12) );
+    file.close();
+
+    RUN_EXPECT_ERROR_WITH_STDERR(
+        args << "importtab" << tmp.fileName(), CommandException, "Cannot import file");
+    RUN(args << "size", "3\n");
+
+    QVERIFY( file.open(QIODevice::WriteOnly) );
+    QCOMPARE( file.write(archive), archive.size() );
+    file.close();
+
+    RUN(args << "importtab" << tmp.fileName(), "");
+    RUN(args << "size", "3\n");
+    RUN(args << "str(read(0))[0] + str(read(1))[0] + str(read(2))[0]", "210\n");
+    QVERIFY( !QFile::exists(tmp.fileName() + ".progress") );
+}
+
 void Tests::nextPreviousTab()
 {
     const auto tab1 = testTab(1);
@@ -3933,6 +4181,28 @@ void Tests::scriptCommandWithError()
     m_test->setEnv("COPYQ_TEST_THROW", "0");
 }
 
+void Tests::scriptCommandUpdated()
+{
+    RUN("setCommands([{isScript: true, cmd: 'global.test1 = function() { return 1; }'}])", "");
+    RUN("test1", "1\n");
+
+    RUN("setCommands([{isScript: true, cmd: 'global.test1 = function() { return 2; }'}])", "");
+    RUN("test1", "2\n");
+
+    RUN("setCommands([{isScript: true, enable: false, cmd: 'global.test1 = function() { return 3; }'}])", "");
+    RUN("typeof(global.test1)", "undefined\n");
+}
+
+void Tests::scriptCommandOverrideSimpleCommand()
+{
+    RUN("add" << "A" << "B", "");
+    RUN("size", "2\n");
+
+    RUN("setCommands([{isScript: true, cmd: 'global.size = function() { return 42; }'}])", "");
+    RUN("size", "42\n");
+    RUN("count", "2\n");
+}
+
 void Tests::displayCommand()
 {
     const auto testMime = COPYQ_MIME_PREFIX "test";
@@ -4417,10 +4687,15 @@ int runTests(int argc, char *argv[])
 {
     QRegularExpression onlyPlugins;
     bool runPluginTests = true;
+    bool runBenchmark = false;
 
     if (argc > 1) {
         QString arg = argv[1];
-        if (arg.startsWith("PLUGINS:")) {
+        if (arg == "BENCHMARK") {
+            runBenchmark = true;
+            --argc;
+            ++argv;
+        } else if (arg.startsWith("PLUGINS:")) {
             arg.remove(QRegularExpression("^PLUGINS:"));
             onlyPlugins = QRegularExpression(arg, QRegularExpression::CaseInsensitiveOption);
             --argc;
@@ -4451,6 +4726,16 @@ int runTests(int argc, char *argv[])
 
     int exitCode = 0;
     std::shared_ptr<TestInterfaceImpl> test(new TestInterfaceImpl);
+
+    if (runBenchmark) {
+        QStringList arguments;
+        for (int i = 1; i < argc; ++i)
+            arguments.append( QString::fromUtf8(argv[i]) );
+        exitCode = runClipboardBenchmark(test, arguments);
+        test->stopServer();
+        return exitCode;
+    }
+
     Tests tc(test);
 
     if (onlyPlugins.pattern().isEmpty()) {
@@ -56,6 +56,7 @@ private slots:
     void commandsUnicode();
 
     void commandsAddRead();
+    void commandsSessionPipe();
     void commandsWriteRead();
     void commandChange();
 
@@ -131,8 +132,11 @@ private slots:
     void commandForceUnload();
 
     void commandServerLogAndLogs();
+    void commandMetrics();
+    void commandTraceStartStop();
 
     void classByteArray();
+    void classByteArrayArrayBuffer();
     void classFile();
     void classDir();
     void classTemporaryFile();
@@ -140,6 +144,7 @@ private slots:
     void classItemSelectionGetCurrent();
     void classItemSelectionByteArray();
     void classItemSelectionSort();
+    void classItemSelectionBulkOperations();
     void classSettings();
     void calledWithInstance();
 
@@ -163,6 +168,7 @@ private slots:
     void selectAndCopyOrder();
 
     void sortAndReverse();
+    void sortAndReverseManyItems();
 
     void createTabDialog();
 
@@ -177,13 +183,16 @@ private slots:
     void clipboardToItem();
     void itemToClipboard();
     void tabAdd();
+    void tabKeepCorruptedPrefetched();
     void tabRemove();
     void tabIcon();
     void action();
     void insertRemoveItems();
+    void insertRemoveItemsInBatch();
     void renameTab();
     void renameClipboardTab();
     void importExportTab();
+    void importTabArchiveContinue();
 
     void removeAllFoundItems();
 
@@ -248,6 +257,8 @@ private slots:
     void scriptCommandEnhanceFunction();
     void scriptCommandEndingWithComment();
     void scriptCommandWithError();
+    void scriptCommandUpdated();
+    void scriptCommandOverrideSimpleCommand();
     void displayCommand();
 
     void synchronizeInternalCommands();